@@ -0,0 +1,162 @@
+// Harness wydajnościowy dla priorityqueue.hh.
+//
+//   make bench && ./bench [rozmiar...]
+//
+// Dla każdego rozmiaru i kształtu typów (int/int, string/string, int/int
+// na PoolAllocator) mierzy insert, changeValue, deleteMin, merge i
+// mergeFast: przepustowość (ops/s) oraz percentyle opóźnień p50/p99
+// pojedynczej operacji. Domyślne rozmiary są umiarkowane, żeby przebieg
+// kończył się w sekundy; do pomiarów produkcyjnych podajemy rozmiary
+// z wiersza poleceń (np. ./bench 10000000).
+//
+// Budować z -O2 - patrz cel 'bench' w Makefile.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "priorityqueue.hh"
+#include "poolallocator.hh"
+
+using clk = std::chrono::steady_clock;
+
+struct op_stats {
+    double ops_per_sec;
+    double p50_ns;
+    double p99_ns;
+};
+
+class latency_recorder {
+    std::vector<std::uint64_t> samples;
+    clk::time_point total_start;
+
+   public:
+    explicit latency_recorder(std::size_t n) { samples.reserve(n); }
+
+    void start() { total_start = clk::now(); }
+
+    template <typename Fn>
+    void measure(Fn&& fn) {
+        auto t0 = clk::now();
+        fn();
+        auto t1 = clk::now();
+        samples.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0)
+                .count());
+    }
+
+    op_stats finish() {
+        auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         clk::now() - total_start)
+                         .count();
+        std::sort(samples.begin(), samples.end());
+        op_stats s{};
+        if (!samples.empty()) {
+            s.ops_per_sec = samples.size() * 1e9 / double(total);
+            s.p50_ns = samples[samples.size() / 2];
+            s.p99_ns = samples[samples.size() * 99 / 100];
+        }
+        return s;
+    }
+};
+
+void report(const std::string& type, std::size_t n, const std::string& op,
+            const op_stats& s) {
+    std::cout << type << "\tn=" << n << "\t" << op << "\t"
+              << std::uint64_t(s.ops_per_sec) << " ops/s\tp50="
+              << std::uint64_t(s.p50_ns) << "ns\tp99="
+              << std::uint64_t(s.p99_ns) << "ns" << std::endl;
+}
+
+template <typename Queue, typename MakeKey, typename MakeValue>
+void bench_type(const std::string& type, std::size_t n, MakeKey make_key,
+                MakeValue make_value) {
+    std::mt19937_64 rng(42);
+    std::vector<std::uint64_t> keys(n), values(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = rng();
+        values[i] = rng();
+    }
+
+    // insert
+    Queue q;
+    {
+        latency_recorder rec(n);
+        rec.start();
+        for (std::size_t i = 0; i < n; ++i)
+            rec.measure([&] { q.insert(make_key(keys[i]),
+                                       make_value(values[i])); });
+        report(type, n, "insert", rec.finish());
+    }
+
+    // changeValue na istniejących kluczach
+    {
+        latency_recorder rec(n);
+        rec.start();
+        for (std::size_t i = 0; i < n; ++i)
+            rec.measure([&] { q.changeValue(make_key(keys[i]),
+                                            make_value(values[i] ^ 1)); });
+        report(type, n, "changeValue", rec.finish());
+    }
+
+    // merge (kopiujący) i mergeFast (przepinający węzły)
+    {
+        Queue a(q), b(q);
+        // Ta sama arena co q - warunek mergeFast przy alokatorach ze stanem.
+        Queue src(q.get_allocator());
+        for (std::size_t i = 0; i < n / 4; ++i)
+            src.insert(make_key(rng()), make_value(rng()));
+        Queue src2(src);
+
+        auto t0 = clk::now();
+        a.merge(src);
+        auto t1 = clk::now();
+        b.mergeFast(std::move(src2));
+        auto t2 = clk::now();
+        std::cout << type << "\tn=" << n << "\tmerge\t"
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         t1 - t0)
+                         .count()
+                  << "ms\tmergeFast\t"
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         t2 - t1)
+                         .count()
+                  << "ms" << std::endl;
+    }
+
+    // deleteMin do pustej kolejki
+    {
+        latency_recorder rec(q.size());
+        rec.start();
+        while (!q.empty())
+            rec.measure([&] { q.deleteMin(); });
+        report(type, n, "deleteMin", rec.finish());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::size_t> sizes;
+    for (int i = 1; i < argc; ++i)
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = {1000, 100000};
+
+    auto as_int = [](std::uint64_t x) { return x; };
+    auto as_string = [](std::uint64_t x) { return std::to_string(x); };
+
+    for (std::size_t n : sizes) {
+        bench_type<PriorityQueue<std::uint64_t, std::uint64_t>>(
+            "int/int", n, as_int, as_int);
+        bench_type<PriorityQueue<std::uint64_t, std::uint64_t,
+                                 PoolAllocator<void>>>("int/int+pool", n,
+                                                       as_int, as_int);
+        bench_type<PriorityQueue<std::string, std::string>>(
+            "string/string", n, as_string, as_string);
+    }
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+#ifndef _JNP1_BOUNDEDPRIORITYQUEUE_HH_
+#define _JNP1_BOUNDEDPRIORITYQUEUE_HH_
+
+#include <memory>
+#include <utility>
+
+#include "priorityqueue.hh"
+
+// Adapter "top N po wartości": kolejka o ograniczonej pojemności, która po
+// zapełnieniu przyjmuje tylko elementy większe od bieżącego minimum i
+// wypycha to minimum. Element poniżej progu jest odrzucany jednym
+// porównaniem z minValue() [O(1)], bez żadnej alokacji - przy strumieniu,
+// w którym większość elementów nie mieści się w czołówce, to zamienia
+// większość insertów w pojedynczą gałąź.
+template <typename K, typename V, typename Allocator = std::allocator<void>,
+          typename Features = DefaultQueueFeatures>
+class BoundedPriorityQueue {
+   public:
+    using queue_type = PriorityQueue<K, V, Allocator, Features>;
+    using size_type = typename queue_type::size_type;
+
+   protected:
+    queue_type queue;
+    size_type max_size;
+
+   public:
+    explicit BoundedPriorityQueue(size_type max_size,
+                                  const Allocator& alloc = Allocator())
+        : queue(alloc), max_size(max_size) {}
+
+    // Zwraca false, gdy element nie zmieścił się w czołówce (kolejka pełna,
+    // wartość nie większa od minimum); true, gdy został wstawiony
+    // [O(1) dla odrzucenia, O(log max_size) dla wstawienia]
+    bool insert(const K& key, const V& value) {
+        if (queue.size() >= max_size) {
+            if (max_size == 0 || !(queue.minValue() < value)) return false;
+            queue.insert(key, value);
+            queue.deleteMin();
+            return true;
+        }
+        queue.insert(key, value);
+        return true;
+    }
+
+    bool empty() const noexcept { return queue.empty(); }
+    size_type size() const noexcept { return queue.size(); }
+    size_type capacity() const noexcept { return max_size; }
+
+    const V& minValue() const { return queue.minValue(); }
+    const V& maxValue() const { return queue.maxValue(); }
+    const K& minKey() const { return queue.minKey(); }
+    const K& maxKey() const { return queue.maxKey(); }
+
+    void deleteMin() { queue.deleteMin(); }
+    void deleteMax() { queue.deleteMax(); }
+    std::pair<K, V> popMin() { return queue.popMin(); }
+    std::pair<K, V> popMax() { return queue.popMax(); }
+
+    typename queue_type::const_iterator begin() const noexcept {
+        return queue.begin();
+    }
+    typename queue_type::const_iterator end() const noexcept {
+        return queue.end();
+    }
+
+    // Dostęp tylko do odczytu do kolejki pod spodem oraz przejęcie jej
+    // zawartości (adapter zostaje pusty).
+    const queue_type& base() const noexcept { return queue; }
+    queue_type release() { return std::move(queue); }
+};
+
+#endif /* end of include guard: _JNP1_BOUNDEDPRIORITYQUEUE_HH_ */
@@ -0,0 +1,166 @@
+#ifndef _JNP1_BUFFEREDPRIORITYQUEUE_HH_
+#define _JNP1_BUFFEREDPRIORITYQUEUE_HH_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+
+// Bufor wsadowy nad PriorityQueue dla wielu producentów: insert() tylko
+// dokłada parę do pasma bufora wybranego haszem identyfikatora wątku
+// (własny mutex na pasmo, więc producenci praktycznie się nie stykają),
+// a dopiero flush() - jawny, wymuszony odczytem albo przepełnieniem pasma -
+// wsypuje zebrane paczki jednym hintowanym insertem wsadowym do kolejki.
+// Przy zrywowym ruchu paczka z całego zrywu kosztuje jedno sortowanie
+// i zamortyzowane O(1) na element w indeksach wartości, zamiast pięciu
+// operacji drzewiastych na każdy pojedynczy insert.
+//
+// Odczyty (minValue, popMin, size) najpierw wymuszają flush - widzą więc
+// zawsze stan ze wszystkimi zbuforowanymi parami. Jak w
+// ConcurrentPriorityQueue, wszystkie operacje są bezpieczne wątkowo.
+template <typename K, typename V, typename Allocator = std::allocator<void>,
+          typename Features = DefaultQueueFeatures>
+class BufferedPriorityQueue {
+   public:
+    using queue_type = PriorityQueue<K, V, Allocator, Features>;
+    using size_type = typename queue_type::size_type;
+
+   protected:
+    struct lane {
+        std::mutex mutex;
+        std::vector<std::pair<K, V>> items;
+    };
+
+    // unique_ptr, bo mutex nie jest przenaszalny, a pasma żyją w wektorze
+    std::vector<std::unique_ptr<lane>> lanes;
+    size_type flush_threshold;
+
+    mutable std::mutex queue_mutex;
+    queue_type queue;
+
+    lane& lane_for_this_thread() {
+        return *lanes[std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                      lanes.size()];
+    }
+
+    static size_type default_lane_count() {
+        size_type n = std::thread::hardware_concurrency();
+        return n == 0 ? 8 : n;
+    }
+
+    // Zbiera zawartość wszystkich pasm do jednej paczki (pasma są
+    // blokowane pojedynczo, każde tylko na czas wymiany wektora).
+    std::vector<std::pair<K, V>> drain_lanes() {
+        std::vector<std::pair<K, V>> batch;
+        for (auto& l : lanes) {
+            std::vector<std::pair<K, V>> taken;
+            {
+                std::lock_guard<std::mutex> lock(l->mutex);
+                taken.swap(l->items);
+            }
+            if (batch.empty())
+                batch = std::move(taken);
+            else
+                batch.insert(batch.end(),
+                             std::make_move_iterator(taken.begin()),
+                             std::make_move_iterator(taken.end()));
+        }
+        return batch;
+    }
+
+   public:
+    explicit BufferedPriorityQueue(
+        size_type flush_threshold = 1024,
+        size_type num_lanes = default_lane_count(),
+        const Allocator& alloc = Allocator())
+        : flush_threshold(flush_threshold == 0 ? 1 : flush_threshold),
+          queue(alloc) {
+        if (num_lanes == 0) num_lanes = 1;
+        lanes.reserve(num_lanes);
+        for (size_type i = 0; i < num_lanes; ++i)
+            lanes.emplace_back(new lane{});
+    }
+
+    BufferedPriorityQueue(const BufferedPriorityQueue&) = delete;
+    BufferedPriorityQueue& operator=(const BufferedPriorityQueue&) = delete;
+
+    // Dokłada parę do pasma producenta [O(1) poza progiem]; pełne pasmo
+    // jest od razu wsypywane do kolejki jako paczka.
+    void insert(const K& key, const V& value) {
+        lane& l = lane_for_this_thread();
+        std::vector<std::pair<K, V>> full;
+        {
+            std::lock_guard<std::mutex> lock(l.mutex);
+            l.items.emplace_back(key, value);
+            if (l.items.size() >= flush_threshold) full.swap(l.items);
+        }
+        if (!full.empty()) {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            queue.insert(std::move(full));
+        }
+    }
+
+    // Wsypuje wszystkie zbuforowane pary do kolejki jednym insertem
+    // wsadowym; zwraca liczbę zastosowanych par
+    size_type flush() {
+        std::vector<std::pair<K, V>> batch = drain_lanes();
+        size_type count = batch.size();
+        if (count > 0) {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            queue.insert(std::move(batch));
+        }
+        return count;
+    }
+
+    bool empty() {
+        flush();
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return queue.empty();
+    }
+
+    size_type size() {
+        flush();
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return queue.size();
+    }
+
+    // Jak w ConcurrentPriorityQueue: zwrot przez wartość, bo referencja
+    // do wnętrza kolejki nie przeżyłaby zwolnienia zamka.
+    V minValue() {
+        flush();
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return queue.minValue();
+    }
+    V maxValue() {
+        flush();
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return queue.maxValue();
+    }
+
+    bool tryPopMin(K& key, V& value) {
+        flush();
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return queue.tryPopMin(key, value);
+    }
+
+    std::pair<K, V> popMin() {
+        K key;
+        V value;
+        if (!tryPopMin(key, value)) throw PriorityQueueEmptyException();
+        return std::pair<K, V>(std::move(key), std::move(value));
+    }
+
+    // Przejęcie całej zawartości (z buforami włącznie) jako zwykłej kolejki;
+    // adapter zostaje pusty.
+    queue_type release() {
+        flush();
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return std::move(queue);
+    }
+};
+
+#endif /* end of include guard: _JNP1_BUFFEREDPRIORITYQUEUE_HH_ */
@@ -0,0 +1,191 @@
+#ifndef _JNP1_CONCURRENTPRIORITYQUEUE_HH_
+#define _JNP1_CONCURRENTPRIORITYQUEUE_HH_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+
+// Współbieżna fasada nad PriorityQueue: elementy są rozrzucane po N
+// wewnętrznych kolejkach haszem klucza, każda kolejka ma własny mutex.
+// Operacje na jednym kluczu (insert, changeValue) biorą tylko jeden
+// zamek, więc producenci na różnych kluczach skalują się niemal liniowo;
+// operacje globalne (popMin, minValue, merge, swap) biorą zamki wszystkich
+// shardów w stałej kolejności, co wyklucza zakleszczenia.
+// Wymaga haszowalnego K (domyślnie std::hash<K>).
+template <typename K, typename V, typename Allocator = std::allocator<void>,
+          typename Hash = std::hash<K>>
+class ConcurrentPriorityQueue {
+   public:
+    using queue_type = PriorityQueue<K, V, Allocator>;
+    using size_type = typename queue_type::size_type;
+
+   protected:
+    struct shard {
+        mutable std::mutex mutex;
+        queue_type queue;
+    };
+
+    // unique_ptr, bo mutex nie jest przenaszalny, a shardy żyją w wektorze
+    std::vector<std::unique_ptr<shard>> shards;
+    Hash hasher;
+
+    shard& shard_for(const K& key) const {
+        return *shards[hasher(key) % shards.size()];
+    }
+
+    // Zamki wszystkich shardów w stałej kolejności (indeksowej)
+    std::vector<std::unique_lock<std::mutex>> lock_all() const {
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(shards.size());
+        for (const auto& s : shards)
+            locks.emplace_back(s->mutex);
+        return locks;
+    }
+
+    static size_type default_shard_count() {
+        size_type n = std::thread::hardware_concurrency();
+        return n == 0 ? 8 : n;
+    }
+
+   public:
+    explicit ConcurrentPriorityQueue(
+        size_type num_shards = default_shard_count(),
+        const Allocator& alloc = Allocator()) {
+        if (num_shards == 0) num_shards = 1;
+        shards.reserve(num_shards);
+        for (size_type i = 0; i < num_shards; ++i) {
+            shards.emplace_back(new shard{});
+            shards.back()->queue = queue_type(alloc);
+        }
+    }
+
+    ConcurrentPriorityQueue(const ConcurrentPriorityQueue&) = delete;
+    ConcurrentPriorityQueue& operator=(const ConcurrentPriorityQueue&) =
+        delete;
+
+    bool empty() const {
+        for (const auto& s : shards) {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            if (!s->queue.empty()) return false;
+        }
+        return true;
+    }
+
+    size_type size() const {
+        size_type total = 0;
+        for (const auto& s : shards) {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            total += s->queue.size();
+        }
+        return total;
+    }
+
+    void insert(const K& key, const V& value) {
+        shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.queue.insert(key, value);
+    }
+
+    void changeValue(const K& key, const V& value) {
+        shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.queue.changeValue(key, value);
+    }
+
+    // Minimum globalne to minimum z minimów shardów; trzymamy wszystkie
+    // zamki, żeby wybór i usunięcie były jedną niepodzielną operacją.
+    bool tryPopMin(K& key, V& value) {
+        auto locks = lock_all();
+        shard* best = nullptr;
+        for (const auto& s : shards) {
+            if (s->queue.empty()) continue;
+            if (best == nullptr || s->queue.minValue() < best->queue.minValue())
+                best = s.get();
+        }
+        if (best == nullptr) return false;
+        return best->queue.tryPopMin(key, value);
+    }
+
+    std::pair<K, V> popMin() {
+        K key;
+        V value;
+        if (!tryPopMin(key, value)) throw PriorityQueueEmptyException();
+        return std::pair<K, V>(std::move(key), std::move(value));
+    }
+
+    V minValue() const {
+        auto locks = lock_all();
+        const queue_type* best = nullptr;
+        for (const auto& s : shards) {
+            if (s->queue.empty()) continue;
+            if (best == nullptr || s->queue.minValue() < best->minValue())
+                best = &s->queue;
+        }
+        if (best == nullptr) throw PriorityQueueEmptyException();
+        return best->minValue();
+    }
+
+    // Scala zawartość queue do *this; zamki obu kolejek brane są w stałym
+    // porządku (najpierw obiekt o niższym adresie), żeby dwa krzyżowe
+    // merge() się nie zakleszczyły.
+    void merge(ConcurrentPriorityQueue& queue) {
+        if (this == &queue) return;
+        ConcurrentPriorityQueue* first = this < &queue ? this : &queue;
+        ConcurrentPriorityQueue* second = this < &queue ? &queue : this;
+        auto locks1 = first->lock_all();
+        auto locks2 = second->lock_all();
+        for (auto& src : queue.shards) {
+            // Klucze mogą trafiać do innych shardów (inna liczba shardów),
+            // więc rozdzielamy je pojedynczo po haszu.
+            K key;
+            V value;
+            while (src->queue.tryPopMin(key, value))
+                shard_for(key).queue.insert(key, value);
+        }
+    }
+
+    // Wymieniamy zawartość shardów, nie wektory shards: shard_for()
+    // czyta shards bez zamka (liczba shardów jest stała od konstrukcji),
+    // więc podmiana samego wektora ścigałaby się z każdym insert().
+    void swap(ConcurrentPriorityQueue& queue) {
+        if (this == &queue) return;
+        ConcurrentPriorityQueue* first = this < &queue ? this : &queue;
+        ConcurrentPriorityQueue* second = this < &queue ? &queue : this;
+        auto locks1 = first->lock_all();
+        auto locks2 = second->lock_all();
+
+        if (shards.size() == queue.shards.size()) {
+            for (std::size_t i = 0; i < shards.size(); ++i)
+                shards[i]->queue.swap(queue.shards[i]->queue);
+            return;
+        }
+
+        // Różne liczby shardów: klucze muszą trafić do shardów po haszu
+        // strony docelowej, więc rozdzielamy elementy pojedynczo, jak
+        // w merge().
+        std::vector<std::pair<K, V>> mine, theirs;
+        K key;
+        V value;
+        for (auto& s : shards)
+            while (s->queue.tryPopMin(key, value))
+                mine.emplace_back(std::move(key), std::move(value));
+        for (auto& s : queue.shards)
+            while (s->queue.tryPopMin(key, value))
+                theirs.emplace_back(std::move(key), std::move(value));
+        for (auto& kv : theirs) {
+            shard& dst = shard_for(kv.first);
+            dst.queue.insert(std::move(kv.first), std::move(kv.second));
+        }
+        for (auto& kv : mine) {
+            shard& dst = queue.shard_for(kv.first);
+            dst.queue.insert(std::move(kv.first), std::move(kv.second));
+        }
+    }
+};
+
+#endif /* end of include guard: _JNP1_CONCURRENTPRIORITYQUEUE_HH_ */
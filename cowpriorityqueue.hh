@@ -0,0 +1,128 @@
+#ifndef _JNP1_COWPRIORITYQUEUE_HH_
+#define _JNP1_COWPRIORITYQUEUE_HH_
+
+#include <memory>
+#include <utility>
+
+#include "priorityqueue.hh"
+
+// Kolejka z kopiowaniem przy zapisie (copy-on-write): klony współdzielą
+// jedną PriorityQueue za shared_ptr, więc kopia to inkrementacja licznika
+// [O(1)] zamiast głębokiej kopii trzech drzew [O(n)]. Dopiero pierwsza
+// mutacja współdzielonego stanu wykonuje prawdziwą kopię (detach).
+// To jest tryb pod migawki do odczytu: czytelnik klonuje kolejkę bez
+// zatrzymywania pisarza na czas kopiowania, a pisarz płaci za kopię raz,
+// przy najbliższej mutacji, zamiast przy każdej migawce.
+//
+// Celowo adapter, a nie tryb samej PriorityQueue: tamta klasa daje silne
+// gwarancje wyjątkowe oparte o ręczne wycofywanie wstawień i uchwyty do
+// wpisów; leniwe kopiowanie pod spodem unieważniałoby uchwyty i iteratory
+// w momencie detach. Tu granica jest jawna: uchwytów nie wystawiamy, a
+// iteratory unieważnia każda mutacja klonu.
+//
+// Uwaga: współdzielenie nie jest synchronizowane - klony wolno czytać
+// równolegle, ale mutacje wymagają wyłączności jak przy zwykłych
+// kontenerach (albo ConcurrentPriorityQueue).
+template <typename K, typename V, typename Allocator = std::allocator<void>,
+          typename Features = DefaultQueueFeatures>
+class CowPriorityQueue {
+   public:
+    using queue_type = PriorityQueue<K, V, Allocator, Features>;
+    using size_type = typename queue_type::size_type;
+    using const_iterator = typename queue_type::const_iterator;
+
+   protected:
+    std::shared_ptr<queue_type> queue;
+
+    // Zapewnia wyłączność stanu przed mutacją; kopia zdarza się tylko
+    // wtedy, gdy ktoś faktycznie trzyma klon [O(1) albo O(n) przy
+    // pierwszej mutacji po sklonowaniu].
+    queue_type& detach() {
+        if (queue.use_count() > 1)
+            queue = std::make_shared<queue_type>(*queue);
+        return *queue;
+    }
+
+   public:
+    CowPriorityQueue() : CowPriorityQueue(Allocator()) {}
+    explicit CowPriorityQueue(const Allocator& alloc)
+        : queue(std::make_shared<queue_type>(alloc)) {}
+    explicit CowPriorityQueue(queue_type base)
+        : queue(std::make_shared<queue_type>(std::move(base))) {}
+
+    // Klonowanie [O(1)] - obie kolejki wskazują ten sam stan.
+    CowPriorityQueue(const CowPriorityQueue&) = default;
+    CowPriorityQueue(CowPriorityQueue&& other) noexcept
+        : queue(std::move(other.queue)) {
+        other.queue = std::make_shared<queue_type>();
+    }
+    CowPriorityQueue& operator=(const CowPriorityQueue&) = default;
+    CowPriorityQueue& operator=(CowPriorityQueue&& other) {
+        if (this == &other) return *this;
+        queue = std::move(other.queue);
+        other.queue = std::make_shared<queue_type>();
+        return *this;
+    }
+
+    // true, gdy stan jest współdzielony z innym klonem (najbliższa mutacja
+    // wykona głęboką kopię) [O(1)]
+    bool shared() const noexcept { return queue.use_count() > 1; }
+
+    bool empty() const noexcept { return queue->empty(); }
+    size_type size() const noexcept { return queue->size(); }
+
+    const V& minValue() const { return queue->minValue(); }
+    const V& maxValue() const { return queue->maxValue(); }
+    const K& minKey() const { return queue->minKey(); }
+    const K& maxKey() const { return queue->maxKey(); }
+
+    const_iterator begin() const noexcept { return queue->begin(); }
+    const_iterator end() const noexcept { return queue->end(); }
+
+    template <typename Fn>
+    void for_each_ordered(Fn&& fn) const {
+        queue->for_each_ordered(std::forward<Fn>(fn));
+    }
+
+    // Mutacje; każda najpierw odłącza stan od ewentualnych klonów.
+    // Uchwytu z insert() celowo nie przekazujemy dalej - wskazywałby na
+    // stan sprzed detach któregoś z klonów.
+    void insert(const K& key, const V& value) { detach().insert(key, value); }
+    void insert(std::vector<std::pair<K, V>>&& batch) {
+        detach().insert(std::move(batch));
+    }
+
+    void changeValue(const K& key, const V& value) {
+        detach().changeValue(key, value);
+    }
+
+    void deleteMin() { detach().deleteMin(); }
+    void deleteMax() { detach().deleteMax(); }
+    std::pair<K, V> popMin() { return detach().popMin(); }
+    std::pair<K, V> popMax() { return detach().popMax(); }
+    bool tryPopMin(K& key, V& value) { return detach().tryPopMin(key, value); }
+
+    bool erase(const K& key) { return detach().erase(key); }
+    std::pair<K, V> extract(const K& key) { return detach().extract(key); }
+
+    void merge(CowPriorityQueue& other) {
+        if (this == &other) return;
+        detach().merge(other.detach());
+    }
+
+    void swap(CowPriorityQueue& other) noexcept { queue.swap(other.queue); }
+
+    // Dostęp tylko do odczytu do kolejki pod spodem (np. serialize()).
+    const queue_type& base() const noexcept { return *queue; }
+
+    friend bool operator==(const CowPriorityQueue& lhs,
+                           const CowPriorityQueue& rhs) {
+        return lhs.queue == rhs.queue || *lhs.queue == *rhs.queue;
+    }
+    friend bool operator!=(const CowPriorityQueue& lhs,
+                           const CowPriorityQueue& rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+#endif /* end of include guard: _JNP1_COWPRIORITYQUEUE_HH_ */
@@ -0,0 +1,63 @@
+#ifndef _JNP1_PARALLELMERGE_HH_
+#define _JNP1_PARALLELMERGE_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+
+// Równoległe scalanie wielu kolejek: turniej rund parowych, w każdej rundzie
+// rozłączne pary kolejek są zszywane przez mergeFast() na puli wątków.
+// Rund jest O(log k), a całkowita praca nie przekracza pracy sekwencyjnego
+// mergeAll(); przy k kolejkach podobnej wielkości skalowanie jest bliskie
+// liczbie rdzeni, bo pary nie dzielą żadnego stanu.
+//
+// W osobnym nagłówku, żeby priorityqueue.hh nie ciągnął <thread> (i -pthread)
+// dla kodu, który scalania równoległego nie używa.
+//
+// Wymagania: jak w mergeFast() - przy alokatorach ze stanem wszystkie kolejki
+// muszą dzielić równy alokator; porównania K i V nie mogą rzucać (wyjątek
+// w cudzym wątku kończy program).
+template <typename K, typename V, typename Allocator, typename Features>
+PriorityQueue<K, V, Allocator, Features> mergeAllParallel(
+    std::vector<PriorityQueue<K, V, Allocator, Features>>&& queues,
+    unsigned threads = std::thread::hardware_concurrency()) {
+    using queue_type = PriorityQueue<K, V, Allocator, Features>;
+
+    if (queues.empty()) return queue_type();
+    if (threads == 0) threads = 1;
+
+    std::size_t n = queues.size();
+    while (n > 1) {
+        // Kolejki [0, mid) są celami, [mid, n) źródłami; para i to
+        // (queues[i], queues[mid + i]) - rozłączne, więc bez blokad.
+        std::size_t half = n / 2;
+        std::size_t mid = n - half;
+
+        std::size_t workers = std::min<std::size_t>(threads, half);
+        if (workers <= 1) {
+            for (std::size_t i = 0; i < half; ++i)
+                queues[i].mergeFast(std::move(queues[mid + i]));
+        } else {
+            std::atomic<std::size_t> next(0);
+            std::vector<std::thread> pool;
+            pool.reserve(workers);
+            for (std::size_t w = 0; w < workers; ++w)
+                pool.emplace_back([&queues, &next, half, mid] {
+                    for (std::size_t i = next.fetch_add(1); i < half;
+                         i = next.fetch_add(1))
+                        queues[i].mergeFast(std::move(queues[mid + i]));
+                });
+            for (std::thread& t : pool) t.join();
+        }
+
+        n = mid;
+    }
+
+    return std::move(queues.front());
+}
+
+#endif /* end of include guard: _JNP1_PARALLELMERGE_HH_ */
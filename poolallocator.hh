@@ -0,0 +1,119 @@
+#ifndef _JNP1_POOLALLOCATOR_HH_
+#define _JNP1_POOLALLOCATOR_HH_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Prosta arena typu bump/pool dla małych węzłów kontenerów drzewiastych.
+// Alokacje pojedynczych węzłów trafiają do dużych slabów, zwalniane węzły
+// wracają na listę wolnych bloków danej klasy rozmiaru, więc węzły jednej
+// kolejki leżą blisko siebie w pamięci.
+// Arena nie jest bezpieczna wątkowo - jedna arena na jedną kolejkę.
+class PoolArena {
+   protected:
+    static const std::size_t slab_size = std::size_t(1) << 16;
+    static const std::size_t granularity = alignof(std::max_align_t);
+    // Klasy rozmiaru co 'granularity' bajtów, do 512 B; większe bloki
+    // idą wprost do operator new (węzły drzew nigdy tyle nie mają).
+    static const std::size_t num_classes = 512 / granularity;
+
+    struct free_node {
+        free_node* next;
+    };
+
+    std::vector<std::unique_ptr<char[]>> slabs;
+    char* bump = nullptr;
+    std::size_t bump_left = 0;
+    free_node* free_lists[num_classes] = {};
+
+    static std::size_t round_up(std::size_t bytes) {
+        if (bytes < sizeof(free_node)) bytes = sizeof(free_node);
+        return (bytes + granularity - 1) / granularity * granularity;
+    }
+
+   public:
+    PoolArena() = default;
+    PoolArena(const PoolArena&) = delete;
+    PoolArena& operator=(const PoolArena&) = delete;
+
+    void* allocate(std::size_t bytes) {
+        bytes = round_up(bytes);
+        std::size_t cls = bytes / granularity - 1;
+        if (cls >= num_classes) return ::operator new(bytes);
+
+        if (free_lists[cls] != nullptr) {
+            free_node* node = free_lists[cls];
+            free_lists[cls] = node->next;
+            return node;
+        }
+        if (bump_left < bytes) {
+            slabs.emplace_back(new char[slab_size]);
+            bump = slabs.back().get();
+            bump_left = slab_size;
+        }
+        void* result = bump;
+        bump += bytes;
+        bump_left -= bytes;
+        return result;
+    }
+
+    void deallocate(void* ptr, std::size_t bytes) noexcept {
+        bytes = round_up(bytes);
+        std::size_t cls = bytes / granularity - 1;
+        if (cls >= num_classes) {
+            ::operator delete(ptr);
+            return;
+        }
+        free_node* node = static_cast<free_node*>(ptr);
+        node->next = free_lists[cls];
+        free_lists[cls] = node;
+    }
+};
+
+// Alokator STL nad wspólną areną; kopie i rebindy dzielą tę samą arenę,
+// więc wszystkie kontenery jednej kolejki alokują z jednych slabów.
+template <typename T>
+class PoolAllocator {
+    template <typename U>
+    friend class PoolAllocator;
+
+    std::shared_ptr<PoolArena> arena;
+
+   public:
+    using value_type = T;
+
+    // Arena to jeden shared_ptr, więc wędruje razem z kontenerem przy
+    // przypisaniu i swapie; bez tych cech kontenery trzymałyby starą arenę
+    // (swap i move-assign niezależnie zbudowanych kolejek byłyby UB po
+    // [container.reqmts], a węzły mogłyby przeżyć własną arenę).
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    PoolAllocator() : arena(std::make_shared<PoolArena>()) {}
+    explicit PoolAllocator(std::shared_ptr<PoolArena> arena)
+        : arena(std::move(arena)) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept
+        : arena(other.arena) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T)));
+    }
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        arena->deallocate(ptr, n * sizeof(T));
+    }
+
+    friend bool operator==(const PoolAllocator& lhs, const PoolAllocator& rhs) {
+        return lhs.arena == rhs.arena;
+    }
+    friend bool operator!=(const PoolAllocator& lhs, const PoolAllocator& rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+#endif /* end of include guard: _JNP1_POOLALLOCATOR_HH_ */
@@ -1,11 +1,18 @@
 #ifndef _JNP1_PRIORITYQUEUE_HH_
 #define _JNP1_PRIORITYQUEUE_HH_
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <exception>
+#include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 class PriorityQueueEmptyException : public std::exception {
    public:
@@ -23,109 +30,767 @@ class PriorityQueueNotFoundException : public std::exception {
     }
 };
 
-template <typename K, typename V>
+class PriorityQueueSnapshotException : public std::exception {
+   public:
+    PriorityQueueSnapshotException() = default;
+    virtual const char* what() const noexcept(true) {
+        return "Priority queue snapshot is truncated or corrupt.";
+    }
+};
+
+namespace pq_detail {
+
+// Małe, trywialnie kopiowalne typy nie zyskują nic na boksowaniu w
+// shared_ptr - kontrolny blok, atomowe liczniki i skok po wskaźniku przy
+// każdym porównaniu kosztują więcej niż skopiowanie wartości.
+constexpr std::size_t inline_storage_limit = 2 * sizeof(void*);
+
+template <typename T>
+constexpr bool use_inline_storage =
+    std::is_trivially_copyable<T>::value && sizeof(T) <= inline_storage_limit;
+
+// Czy goły operator< na T nie rzuca (specyfikator noexcept raw_less).
+template <typename T>
+constexpr bool nothrow_less = noexcept(std::declval<T&>() < std::declval<T&>());
+
+// Czy dla T istnieje std::hash (warunek utrzymywania haszu zawartości).
+template <typename T, typename = void>
+constexpr bool is_hashable = false;
+template <typename T>
+constexpr bool is_hashable<
+    T, std::void_t<decltype(std::hash<T>()(std::declval<const T&>()))>> = true;
+
+// Domyślny porządek: goły operator< na nie-const referencjach, bo część
+// typów w testach porównuje się metodami bez const (std::less wymaga
+// const K&). Własny porządek (np. std::greater<V>) podaje się parametrami
+// KeyCompare/ValueCompare kolejki.
+struct raw_less {
+    template <typename T>
+    bool operator()(T& lhs, T& rhs) const noexcept(nothrow_less<T>) {
+        return lhs < rhs;
+    }
+};
+
+// box<T> ujednolica przechowywanie klucza/wartości: dla małych trywialnie
+// kopiowalnych typów trzyma T w miejscu, dla cięższych - shared_ptr<T>
+// ze współdzieleniem jak dotychczas. Interfejs naśladuje shared_ptr
+// (dereferencja z const boxa daje T&, bo część typów w testach porównuje
+// się metodami bez const).
+template <typename T, bool Inline = use_inline_storage<T>>
+class box;
+
+template <typename T>
+class box<T, true> {
+    mutable T val;
+
+   public:
+    box() = default;
+    T& operator*() const noexcept { return val; }
+    long use_count() const noexcept { return 1; }
+
+    static box make(const T& v) {
+        box b;
+        b.val = v;
+        return b;
+    }
+    static box make(T&& v) { return make(v); }
+
+    // Porządek i równość po wartości (boksowana wersja porównuje adresy,
+    // tu adresy nie mają znaczenia).
+    friend bool operator<(const box& lhs, const box& rhs) {
+        return *lhs < *rhs;
+    }
+    friend bool operator==(const box& lhs, const box& rhs) {
+        return *lhs == *rhs;
+    }
+};
+
+template <typename T>
+class box<T, false> {
+    std::shared_ptr<T> ptr;
+
+   public:
+    box() = default;
+    explicit box(std::shared_ptr<T> p) : ptr(std::move(p)) {}
+    T& operator*() const noexcept { return *ptr; }
+    long use_count() const noexcept { return ptr.use_count(); }
+
+    static box make(const T& v) { return box(std::make_shared<T>(v)); }
+    static box make(T&& v) { return box(std::make_shared<T>(std::move(v))); }
+
+    friend bool operator<(const box& lhs, const box& rhs) {
+        return lhs.ptr < rhs.ptr;
+    }
+    friend bool operator==(const box& lhs, const box& rhs) {
+        return lhs.ptr == rhs.ptr;
+    }
+};
+
+// Płaski zamiennik std::multiset dla indeksów po wartości: posortowany
+// vector, w którym każde porównanie trafia w sąsiednie linie pamięci
+// zamiast gonić węzły drzewa. Usunięcie z przodu (deleteMin) tylko
+// przesuwa leniwy przedrostek head [zamortyzowane O(1)]; wstawienie i
+// usunięcie ze środka przesuwa ogon [O(n)] - stąd ten backend jest dla
+// obciążeń czytająco-zdejmujących, nie dla częstych wstawień w środek.
+// Implementuje tylko wycinek interfejsu multiset używany przez kolejkę.
+template <typename T, typename Compare, typename Alloc>
+class flat_multiset {
+    std::vector<T, Alloc> data;
+    std::size_t head = 0;  // elementy [0, head) są leniwie usunięte
+    Compare comp;
+
+    // Zwalniamy martwy przedrostek, gdy przerośnie żywą część (trzyma
+    // jeszcze boxy/shared_ptr, więc nie może rosnąć bez ograniczeń).
+    void maybe_compact() {
+        if (head >= 16 && 2 * head > data.size()) {
+            data.erase(data.begin(), data.begin() + head);
+            head = 0;
+        }
+    }
+
+   public:
+    using iterator = typename std::vector<T, Alloc>::iterator;
+    using const_iterator = typename std::vector<T, Alloc>::const_iterator;
+    using reverse_iterator = typename std::vector<T, Alloc>::reverse_iterator;
+    using const_reverse_iterator =
+        typename std::vector<T, Alloc>::const_reverse_iterator;
+    using size_type = typename std::vector<T, Alloc>::size_type;
+
+    flat_multiset() = default;
+    flat_multiset(const Compare& comp, const Alloc& alloc)
+        : data(alloc), comp(comp) {}
+
+    iterator begin() { return data.begin() + head; }
+    iterator end() { return data.end(); }
+    const_iterator begin() const { return data.begin() + head; }
+    const_iterator end() const { return data.end(); }
+    reverse_iterator rbegin() { return data.rbegin(); }
+    const_reverse_iterator rbegin() const { return data.rbegin(); }
+
+    bool empty() const noexcept { return size() == 0; }
+    size_type size() const noexcept { return data.size() - head; }
+    // Faktycznie zajęte sloty wektora (z luzem i leniwym prefiksem head).
+    size_type capacity() const noexcept { return data.capacity(); }
+    void clear() {
+        data.clear();
+        head = 0;
+    }
+
+    iterator insert(const T& v) {
+        auto pos = std::upper_bound(begin(), end(), v, comp);
+        return data.insert(pos, v);
+    }
+    // Podpowiedź end() przy elemencie nie mniejszym od ostatniego to czysty
+    // push_back [zamortyzowane O(1)] - z tego żyje insert_sorted_run().
+    iterator insert(const_iterator hint, const T& v) {
+        if (hint == data.cend() && (empty() || !comp(v, data.back()))) {
+            data.push_back(v);
+            return std::prev(data.end());
+        }
+        return insert(v);
+    }
+
+    iterator erase(iterator it) {
+        if (it == begin()) {
+            ++head;
+            maybe_compact();
+            return begin();
+        }
+        return data.erase(it);
+    }
+
+    // Wyszukiwanie heterogeniczne jak w multiset z przezroczystym
+    // komparatorem [O(log n), bez gonienia wskaźników].
+    template <typename U>
+    iterator find(const U& key) {
+        auto pos = std::lower_bound(begin(), end(), key, comp);
+        if (pos != end() && !comp(key, *pos)) return pos;
+        return end();
+    }
+
+    template <typename U>
+    iterator lower_bound(const U& key) {
+        return std::lower_bound(begin(), end(), key, comp);
+    }
+    template <typename U>
+    const_iterator lower_bound(const U& key) const {
+        return std::lower_bound(begin(), end(), key, comp);
+    }
+
+    iterator erase(iterator first, iterator last) {
+        if (first == begin()) {
+            head += static_cast<std::size_t>(last - first);
+            maybe_compact();
+            return begin();
+        }
+        return data.erase(first, last);
+    }
+
+    // Odpowiednik multiset::merge: jedna scalona kopia zamiast przepinania
+    // węzłów [O(n + m)], źródło zostaje puste.
+    void merge(flat_multiset& other) {
+        std::vector<T, Alloc> merged(data.get_allocator());
+        merged.reserve(size() + other.size());
+        std::merge(begin(), end(), other.begin(), other.end(),
+                   std::back_inserter(merged), comp);
+        data.swap(merged);
+        head = 0;
+        other.clear();
+    }
+
+    void swap(flat_multiset& other) noexcept {
+        data.swap(other.data);
+        std::swap(head, other.head);
+        std::swap(comp, other.comp);
+    }
+
+    friend bool operator==(const flat_multiset& lhs, const flat_multiset& rhs) {
+        return lhs.size() == rhs.size() &&
+               std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+    friend bool operator!=(const flat_multiset& lhs, const flat_multiset& rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+}  // namespace pq_detail
+
+// Polityka cech kolejki; kolejne flagi wyłączają/zmieniają fragmenty
+// implementacji w czasie kompilacji. Własną politykę najprościej wyprowadzić
+// z DefaultQueueFeatures i przesłonić wybrane stałe.
+struct DefaultQueueFeatures {
+    // Internowanie wartości: indeks all_values pozwala równym wartościom
+    // współdzielić jeden shared_ptr, kosztem trzeciego drzewa dotykanego
+    // przy każdej modyfikacji. Opłaca się tylko, gdy wartości często się
+    // powtarzają i są ciężkie.
+    static constexpr bool value_dedup = true;
+
+    // Liczniki operacji (stats()); wyłączone kompilują się do zera
+    // instrukcji na gorących ścieżkach.
+    static constexpr bool collect_stats = false;
+
+    // Płaskie (vectorowe) indeksy po wartości zamiast drzew czerwono-
+    // czarnych; patrz FlatValueIndex i pq_detail::flat_multiset.
+    static constexpr bool flat_value_index = false;
+
+    // Tryb czysto minimowy: tylko sorted_by_value, bez indeksu kluczy
+    // i internowania; patrz MinOnly.
+    static constexpr bool min_only = false;
+};
+
+// Dla obciążeń z unikalnymi wartościami: pomija all_values w całości -
+// jedna operacja drzewiasta i jedna alokacja węzła mniej na element.
+struct NoValueDedup : DefaultQueueFeatures {
+    static constexpr bool value_dedup = false;
+};
+
+// Kolejka z licznikami - do diagnozowania regresji na kopii ruchu
+// produkcyjnego, nie do stałego użycia na gorącej ścieżce.
+struct WithStats : DefaultQueueFeatures {
+    static constexpr bool collect_stats = true;
+};
+
+// Indeksy po wartości (sorted_by_value, all_values) w posortowanych
+// vectorach zamiast drzew: przegląd i deleteMin chodzą po ciągłej pamięci,
+// kosztem O(n) wstawienia/usunięcia w środku. Dla kolejek czytająco-
+// zdejmujących z rzadkimi wstawieniami w środek zakresu. Uwaga: w tym
+// trybie changeValue() daje tylko podstawową gwarancję wyjątkową
+// (wstawienie unieważnia iteratory, więc stare wpisy wyszukujemy ponownie
+// już po fazie wstawiania).
+struct FlatValueIndex : DefaultQueueFeatures {
+    static constexpr bool flat_value_index = true;
+};
+
+// Kolejka używana wyłącznie jako kopiec minimowy: zostaje samo
+// sorted_by_value - jedna operacja drzewiasta i jedna alokacja węzła na
+// insert zamiast trzech, ok. 60% mniej pamięci. API oparte o indeks
+// kluczy (changeValue, erase(key), contains, ...) oraz strona max są
+// odrzucane w czasie kompilacji.
+struct MinOnly : DefaultQueueFeatures {
+    static constexpr bool min_only = true;
+    static constexpr bool value_dedup = false;
+};
+
+// Skumulowane liczniki kolejki (patrz PriorityQueue::stats()).
+// Razem ze wskaźnikami strukturalnymi (distinctKeys(), averageKeyFanout())
+// pozwalają ocenić np. czy internowanie wartości w ogóle trafia.
+struct PriorityQueueStats {
+    std::uint64_t inserts = 0;
+    std::uint64_t deletes = 0;        // deleteMin/Max, popy, erase, extract
+    std::uint64_t change_values = 0;
+    std::uint64_t merges = 0;
+    std::uint64_t box_allocs = 0;     // utworzone boxy/shared_ptr (alokacje)
+    std::uint64_t value_intern_hits = 0;  // wartość współdzielona zamiast nowej
+};
+
+namespace pq_detail {
+
+// Pusta atrapa składowej stats, gdy liczniki są wyłączone.
+struct no_stats {};
+
+// Atrapa indeksu dla trybu min_only: przyjmuje wywołania wspólnych ścieżek
+// (konstrukcja, swap, clear, merge), nic nie przechowując. Metody, które
+// naprawdę potrzebują indeksu kluczy, odrzucają tryb static_assertem.
+struct null_index {
+    using iterator = void*;
+    null_index() = default;
+    iterator end() noexcept { return nullptr; }
+    template <typename C, typename A>
+    null_index(const C&, const A&) {}
+    void swap(null_index&) noexcept {}
+    void clear() noexcept {}
+    void merge(null_index&) noexcept {}
+    bool empty() const noexcept { return true; }
+    std::size_t size() const noexcept { return 0; }
+};
+
+}  // namespace pq_detail
+
+// Parametr Allocator jest przepinany (rebind) na typy węzłów wszystkich
+// wewnętrznych kontenerów, więc podanie alokatora z areną (np. PoolAllocator
+// z poolallocator.hh) trzyma węzły jednej kolejki w spójnych slabach zamiast
+// rozrzucać je po stercie.
+// KeyCompare i ValueCompare pozwalają podstawić własny porządek klucza i
+// wartości bez opakowywania V w typ pośredniczący z przeciążonym
+// operator< - bezstanowe komparatory wchodzą do wewnętrznych komparatorów
+// przez dziedziczenie (EBO), więc gorące porównanie inline'uje się w
+// całości. Parametry stoją za Features, żeby dotychczasowe instancjacje
+// nie wymagały zmian.
+template <typename K, typename V, typename Allocator = std::allocator<void>,
+          typename Features = DefaultQueueFeatures,
+          typename KeyCompare = pq_detail::raw_less,
+          typename ValueCompare = pq_detail::raw_less>
 class PriorityQueue {
    public:
     using key_type = K;
     using value_type = V;
+    using allocator_type = Allocator;
 
    protected:
-    using key_ptr = std::shared_ptr<K>;
-    using value_ptr = std::shared_ptr<V>;
+    // Dla małych trywialnie kopiowalnych K/V box trzyma wartość w miejscu
+    // zamiast za shared_ptr (patrz pq_detail::box).
+    using key_ptr = pq_detail::box<K>;
+    using value_ptr = pq_detail::box<V>;
     using element = std::pair<key_ptr, value_ptr>;
 
+    // Tryb czysto minimowy (patrz MinOnly).
+    static constexpr bool min_only = Features::min_only;
+
+    // Wartości trzymane w miejscu i tak nie mogą być współdzielone, więc
+    // internowanie nie ma dla nich sensu niezależnie od polityki.
+    static constexpr bool dedup_values = Features::value_dedup &&
+                                         !pq_detail::use_inline_storage<V> &&
+                                         !min_only;
+
+    // Gdy kopie i porównania K/V nie rzucają (typowo typy liczbowe),
+    // rusztowanie wycofywania w insert()/changeValue() - pięć iteratorów,
+    // pięć flag i region try/catch - to martwy kod w najgorętszych
+    // funkcjach; wybieramy wtedy prostoliniową wersję bez niego. Jedynym
+    // możliwym wyjątkiem zostaje bad_alloc z alokacji węzła - po nim para
+    // może być zindeksowana częściowo, co akceptujemy: te kolejki traktują
+    // wyczerpanie pamięci jako błąd fatalny, a nie stan do obsłużenia.
+    // Bramka pyta o skonfigurowane porządki (KeyCompare/ValueCompare),
+    // nie o goły operator< - rzucający komparator podany parametrem
+    // szablonu musi dostać ścieżkę z wycofywaniem.
+    static constexpr bool nothrow_fast_path =
+        std::is_nothrow_copy_constructible<K>::value &&
+        std::is_nothrow_copy_constructible<V>::value &&
+        noexcept(std::declval<const KeyCompare&>()(std::declval<K&>(),
+                                                   std::declval<K&>())) &&
+        noexcept(std::declval<const ValueCompare&>()(std::declval<V&>(),
+                                                     std::declval<V&>()));
+
+    // Gdy K i V są haszowalne, utrzymujemy przy każdej modyfikacji
+    // przemienny (niezależny od kolejności) hasz zawartości - operator==
+    // odrzuca wtedy różne kolejki dwoma porównaniami liczb, a pełny
+    // przebieg po drzewach zostaje tylko dla kolizji.
+    static constexpr bool content_hashing =
+        pq_detail::is_hashable<K> && pq_detail::is_hashable<V>;
+
+    // Hasz pary po zmieszaniu splitmix64, żeby przemienna suma haszy nie
+    // zlewała bliskich par w oczywisty sposób.
+    static std::uint64_t element_hash(const K& key, const V& value) {
+        std::uint64_t h = std::hash<K>()(key) * 0x9e3779b97f4a7c15ULL +
+                          std::hash<V>()(value);
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    template <typename T>
+    using rebind_alloc =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
     template <class Compare = std::less<element>>
-    using element_set = std::multiset<element, Compare>;
+    using element_set = std::multiset<element, Compare, rebind_alloc<element>>;
 
    public:
     using size_type = typename element_set<>::size_type;
 
    protected:
-    // Komparatory
-    class KeyComparer {
+    // Komparatory; przezroczyste (is_transparent), żeby sondować indeksy
+    // surowym K/V bez pakowania argumentu w box - make_shared tylko wtedy,
+    // gdy element naprawdę wchodzi do kolejki. Porządek użytkownika wchodzi
+    // przez prywatne dziedziczenie (EBO: bezstanowy KeyCompare/ValueCompare
+    // nie powiększa komparatora ani węzłów kontenerów).
+    // const_cast po stronie surowego argumentu odpowiada dereferencji boksa
+    // (daje T&), bo część typów w testach porównuje się metodami bez const.
+    class KeyComparer : private KeyCompare {
        public:
-        bool operator()(const key_ptr& lhs, const key_ptr& rhs) {
-            return *lhs < *rhs;
+        using is_transparent = void;
+        KeyComparer() = default;
+        explicit KeyComparer(const KeyCompare& cmp) : KeyCompare(cmp) {}
+        bool operator()(const key_ptr& lhs, const key_ptr& rhs) const {
+            return KeyCompare::operator()(*lhs, *rhs);
+        }
+        bool operator()(const key_ptr& lhs, const K& rhs) const {
+            return KeyCompare::operator()(*lhs, const_cast<K&>(rhs));
+        }
+        bool operator()(const K& lhs, const key_ptr& rhs) const {
+            return KeyCompare::operator()(const_cast<K&>(lhs), *rhs);
+        }
+        bool operator()(const K& lhs, const K& rhs) const {
+            return KeyCompare::operator()(const_cast<K&>(lhs),
+                                          const_cast<K&>(rhs));
         }
     };
 
-    class ValueComparer {
+    class ValueComparer : private ValueCompare {
        public:
-        bool operator()(const value_ptr& lhs, const value_ptr& rhs) {
-            return *lhs < *rhs;
+        using is_transparent = void;
+        ValueComparer() = default;
+        explicit ValueComparer(const ValueCompare& cmp) : ValueCompare(cmp) {}
+        bool operator()(const value_ptr& lhs, const value_ptr& rhs) const {
+            return ValueCompare::operator()(*lhs, *rhs);
+        }
+        bool operator()(const value_ptr& lhs, const V& rhs) const {
+            return ValueCompare::operator()(*lhs, const_cast<V&>(rhs));
+        }
+        bool operator()(const V& lhs, const value_ptr& rhs) const {
+            return ValueCompare::operator()(const_cast<V&>(lhs), *rhs);
+        }
+        bool operator()(const V& lhs, const V& rhs) const {
+            return ValueCompare::operator()(const_cast<V&>(lhs),
+                                            const_cast<V&>(rhs));
         }
     };
 
-    class ValueKeyComparer {
+    class ValueKeyComparer : private KeyComparer, private ValueComparer {
        public:
-        bool operator()(const element& lhs, const element& rhs) {
-            if (*(lhs.second) < *(rhs.second)) return true;
-            if (*(rhs.second) < *(lhs.second)) return false;
-            return *(lhs.first) < *(rhs.first);
+        using is_transparent = void;
+        ValueKeyComparer() = default;
+        ValueKeyComparer(const KeyComparer& kcmp, const ValueComparer& vcmp)
+            : KeyComparer(kcmp), ValueComparer(vcmp) {}
+        bool operator()(const element& lhs, const element& rhs) const {
+            const ValueComparer& vc = *this;
+            if (vc(lhs.second, rhs.second)) return true;
+            if (vc(rhs.second, lhs.second)) return false;
+            return static_cast<const KeyComparer&>(*this)(lhs.first,
+                                                          rhs.first);
+        }
+        // Przezroczyste porównanie z surowym V: sondowanie sorted_by_value
+        // po samej wartości (zapytania zakresowe), bez klucza i bez boxa.
+        bool operator()(const element& lhs, const V& rhs) const {
+            return static_cast<const ValueComparer&>(*this)(lhs.second, rhs);
+        }
+        bool operator()(const V& lhs, const element& rhs) const {
+            return static_cast<const ValueComparer&>(*this)(lhs, rhs.second);
         }
     };
 
    protected:
-    using elements = element_set<ValueKeyComparer>;
-    using value_map = std::map<value_ptr, element_set<>, ValueComparer>;
-    using key_map = std::map<key_ptr, value_map, KeyComparer>;
-    using value_set = std::multiset<value_ptr, ValueComparer>;
+    // Indeksy po wartości mają wymiennie backend drzewiasty (domyślny)
+    // albo płaski (FlatValueIndex); środkowy indeks kluczy zostaje mapą.
+    static constexpr bool flat_value_index = Features::flat_value_index;
 
+    using elements = typename std::conditional<
+        flat_value_index,
+        pq_detail::flat_multiset<element, ValueKeyComparer,
+                                 rebind_alloc<element>>,
+        element_set<ValueKeyComparer>>::type;
+    using value_map =
+        std::map<value_ptr, element_set<>, ValueComparer,
+                 rebind_alloc<std::pair<const value_ptr, element_set<>>>>;
+    // W trybie min_only indeks kluczy i all_values zwijają się do atrap.
+    using key_map = typename std::conditional<
+        min_only, pq_detail::null_index,
+        std::map<key_ptr, value_map, KeyComparer,
+                 rebind_alloc<std::pair<const key_ptr, value_map>>>>::type;
+    using value_set = typename std::conditional<
+        min_only, pq_detail::null_index,
+        typename std::conditional<
+            flat_value_index,
+            pq_detail::flat_multiset<value_ptr, ValueComparer,
+                                     rebind_alloc<value_ptr>>,
+            std::multiset<value_ptr, ValueComparer,
+                          rebind_alloc<value_ptr>>>::type>::type;
+
+    // Alokator, z którego konstruowane są wszystkie kontenery (także te
+    // zagnieżdżone w value_map), żeby dzieliły jedną arenę.
+    Allocator alloc;
+    // Egzemplarze komparatorów kolejki (dla bezstanowych porządków to
+    // puste obiekty); kontenery dostają ich kopie przy konstrukcji.
+    KeyComparer kcomp;
+    ValueComparer vcomp;
+    ValueKeyComparer vkcomp;
     // sortowanie po wartości, a potem po kluczu
     elements sorted_by_value;
     // sortowanie po kluczu, a potem po wartości, a na koniec po adresach
     key_map sorted_by_key;
     // set z wartoścami trzymanymi w kolejce
     value_set all_values;
+    // Liczniki operacji; przy wyłączonym collect_stats to pusta atrapa,
+    // a wszystkie inkrementacje siedzą pod if constexpr.
+    typename std::conditional<Features::collect_stats, PriorityQueueStats,
+                              pq_detail::no_stats>::type counters;
+    // Przemienna suma haszy par (patrz content_hashing); pusta atrapa dla
+    // niehaszowalnych K/V.
+    typename std::conditional<content_hashing, std::uint64_t,
+                              pq_detail::no_stats>::type content_hash{};
+
+    // Zagnieżdżone kontenery muszą być tworzone tymi metodami, a nie
+    // konstruktorem domyślnym - inaczej nie dostaną alokatora kolejki.
+    value_map make_value_map() const { return value_map(vcomp, alloc); }
+    element_set<> make_element_set() const {
+        return element_set<>(std::less<element>(), alloc);
+    }
+
+    // Pusta kolejka o porządkach i alokatorze *this - wspólny punkt
+    // wyjścia przebudowy w deserialize() i compact(). Konstruktor z samym
+    // alokatorem dałby domyślne komparatory, więc wszystkie kontenery
+    // stawiamy jawnie na naszych.
+    PriorityQueue empty_clone() const {
+        PriorityQueue fresh(alloc);
+        fresh.kcomp = kcomp;
+        fresh.vcomp = vcomp;
+        fresh.vkcomp = vkcomp;
+        fresh.sorted_by_value = elements(vkcomp, alloc);
+        fresh.sorted_by_key = key_map(kcomp, alloc);
+        fresh.all_values = value_set(vcomp, alloc);
+        return fresh;
+    }
+
+   public:
+    // Nieprzezroczysty uchwyt na wpis klucza w sorted_by_key, zwracany przez
+    // insert(). Pozwala w changeValue() ominąć wyszukiwanie klucza.
+    // Uchwyt jest ważny, dopóki w kolejce istnieje choć jedna para z tym
+    // kluczem (iteratory std::map nie unieważniają się przy operacjach na
+    // innych kluczach); po usunięciu ostatniej pary użycie uchwytu jest
+    // niezdefiniowane.
+    class handle {
+        friend class PriorityQueue;
+        typename key_map::iterator kit;
+        explicit handle(typename key_map::iterator kit) : kit(kit) {}
+    };
 
    protected:
     element find_element(const key_ptr& k, const value_ptr& v) {
-        auto kit = sorted_by_key.find(k);
-        auto vit = all_values.find(v);
+        if constexpr (min_only) {
+            // Bez indeksów nie ma czego współdzielić.
+            return std::make_pair(k, v);
+        } else {
+            auto kit = sorted_by_key.find(k);
+            auto kk = (kit == sorted_by_key.end()) ? k : (kit->first);
+
+            auto vv = v;
+            if constexpr (dedup_values) {
+                auto vit = all_values.find(v);
+                if (vit != all_values.end()) vv = *vit;
+            }
+
+            return std::make_pair(kk, vv);
+        }
+    }
+    // Wariant sondujący surowymi argumentami: box/shared_ptr powstaje
+    // dopiero przy chybieniu, trafienie nie alokuje nic. Argumenty
+    // przekazane przez rvalue są przy chybieniu przenoszone do boxa
+    // zamiast kopiowane (KK/VV to zawsze jakaś forma K/V; enable_if
+    // odsuwa ten szablon od wywołań z boxami, które mają iść wyżej).
+    template <typename KK, typename VV,
+              typename = typename std::enable_if<!std::is_same<
+                  typename std::decay<KK>::type, key_ptr>::value>::type>
+    element find_element(KK&& key, VV&& value) {
+        if constexpr (min_only) {
+            // Bez sondowania indeksów: świeże boxy wprost z argumentów.
+            key_ptr k = key_ptr::make(std::forward<KK>(key));
+            value_ptr v = value_ptr::make(std::forward<VV>(value));
+            if constexpr (Features::collect_stats) counters.box_allocs += 2;
+            return std::make_pair(k, v);
+        } else {
+            auto kit = sorted_by_key.find(key);
+            key_ptr k = (kit == sorted_by_key.end())
+                            ? key_ptr::make(std::forward<KK>(key))
+                            : kit->first;
+            if constexpr (Features::collect_stats)
+                if (kit == sorted_by_key.end()) ++counters.box_allocs;
 
-        auto kk = (kit == sorted_by_key.end()) ? k : (kit->first);
-        auto vv = (vit == all_values.end()) ? v : (*vit);
+            value_ptr v;
+            if constexpr (dedup_values) {
+                auto vit = all_values.find(value);
+                v = (vit == all_values.end())
+                        ? value_ptr::make(std::forward<VV>(value))
+                        : *vit;
+                if constexpr (Features::collect_stats) {
+                    if (vit == all_values.end())
+                        ++counters.box_allocs;
+                    else
+                        ++counters.value_intern_hits;
+                }
+            } else {
+                v = value_ptr::make(std::forward<VV>(value));
+                if constexpr (Features::collect_stats) ++counters.box_allocs;
+            }
 
-        return make_pair(kk, vv);
+            return std::make_pair(k, v);
+        }
     }
-    element find_element(const K& key, const V& value) {
-        auto k = std::make_shared<K>(key);
-        auto v = std::make_shared<V>(value);
 
-        return find_element(k, v);
+    // Wspólny rdzeń wszystkich wariantów insert()/emplace().
+    template <typename KK, typename VV>
+    handle insert_element(KK&& key, VV&& value) {
+        using std::make_pair;
+        using std::tie;
+
+        key_ptr k;
+        value_ptr v;
+        tie(k, v) =
+            find_element(std::forward<KK>(key), std::forward<VV>(value));
+
+        auto pair_by_value = make_pair(k, v);
+
+        if constexpr (min_only) {
+            // Jedyny indeks: jedna operacja drzewiasta, jedna alokacja
+            // węzła; pojedynczy insert sam z siebie ma silną gwarancję.
+            sorted_by_value.insert(pair_by_value);
+            if constexpr (Features::collect_stats) ++counters.inserts;
+            if constexpr (content_hashing) content_hash += element_hash(*k, *v);
+            return handle(typename key_map::iterator());
+        } else if constexpr (nothrow_fast_path) {
+            // Prostoliniowa wersja bez wycofywania (patrz nothrow_fast_path).
+            sorted_by_value.insert(pair_by_value);
+            auto it2 =
+                sorted_by_key.insert(make_pair(k, make_value_map())).first;
+            auto it3 =
+                it2->second.insert(make_pair(v, make_element_set())).first;
+            it3->second.insert(pair_by_value);
+            if constexpr (dedup_values) all_values.insert(v);
+
+            if constexpr (Features::collect_stats) ++counters.inserts;
+            if constexpr (content_hashing)
+                content_hash += element_hash(*k, *v);
+
+            return handle(it2);
+        } else {
+            // Iteratory
+            typename elements::iterator it1;
+            typename key_map::iterator it2;
+            typename value_map::iterator it3;
+            typename element_set<>::iterator it4;
+            typename value_set::iterator it5;
+
+            bool al1 = false, al2 = false, al3 = false, al4 = false,
+                 al5 = false;
+
+            // Polegamy na silnej gwarancji kontenerów STL (map, set)
+            try {
+                it1 = sorted_by_value.insert(pair_by_value);
+                al1 = true;
+
+                tie(it2, al2) =
+                    sorted_by_key.insert(make_pair(k, make_value_map()));
+
+                tie(it3, al3) =
+                    it2->second.insert(make_pair(v, make_element_set()));
+
+                it4 = it3->second.insert(pair_by_value);
+                al4 = true;
+
+                if constexpr (dedup_values) {
+                    it5 = all_values.insert(v);
+                    al5 = true;
+                }
+            } catch (...) {
+                if (al5) all_values.erase(it5);
+                if (al4) it3->second.erase(it4);
+                if (al3) it2->second.erase(it3);
+                if (al2) sorted_by_key.erase(it2);
+                if (al1) sorted_by_value.erase(it1);
+                throw;
+            }
+
+            if constexpr (Features::collect_stats) ++counters.inserts;
+            if constexpr (content_hashing)
+                content_hash += element_hash(*k, *v);
+
+            return handle(it2);
+        }
     }
 
    public:
     // Konstruktor bezparametrowy tworzący pustą kolejkę [O(1)]
-    PriorityQueue() = default;
+    PriorityQueue() : PriorityQueue(Allocator()) {}
+
+    // Konstruktor tworzący pustą kolejkę alokującą z podanego alokatora [O(1)]
+    explicit PriorityQueue(const Allocator& alloc)
+        : PriorityQueue(KeyCompare(), ValueCompare(), alloc) {}
+
+    // Konstruktor przyjmujący egzemplarze porządków klucza i wartości
+    // (dla komparatorów ze stanem) [O(1)]
+    PriorityQueue(const KeyCompare& key_cmp, const ValueCompare& value_cmp,
+                  const Allocator& alloc = Allocator())
+        : alloc(alloc),
+          kcomp(key_cmp),
+          vcomp(value_cmp),
+          vkcomp(kcomp, vcomp),
+          sorted_by_value(vkcomp, alloc),
+          sorted_by_key(kcomp, alloc),
+          all_values(vcomp, alloc) {}
 
     // Konstruktor kopiujący [O(queue.size())]
     // konstruktory kontenerów zapewniają silną gwarancję
     // jak coś się rzuci, to i tak PriorityQueue się nie utworzy
-    PriorityQueue(const PriorityQueue<K, V>& queue) = default;
+    PriorityQueue(const PriorityQueue& queue) = default;
 
     // Konstruktor przenoszący [O(1)]
-    PriorityQueue(PriorityQueue<K, V>&& queue) noexcept
-        : sorted_by_value(std::move(queue.sorted_by_value)),
+    PriorityQueue(PriorityQueue&& queue) noexcept
+        : alloc(std::move(queue.alloc)),
+          kcomp(queue.kcomp),
+          vcomp(queue.vcomp),
+          vkcomp(queue.vkcomp),
+          sorted_by_value(std::move(queue.sorted_by_value)),
           sorted_by_key(std::move(queue.sorted_by_key)),
-          all_values(std::move(queue.all_values)) {}
+          all_values(std::move(queue.all_values)),
+          counters(queue.counters),
+          content_hash(queue.content_hash) {}
 
     // Operator przypisania [O(queue.size()) dla użycia P = Q, a O(1) dla użycia
     // P = move(Q)]
-    PriorityQueue<K, V>& operator=(const PriorityQueue<K, V>& queue) {
+    PriorityQueue& operator=(const PriorityQueue& queue) {
         if (this == &queue) return *this;
-        PriorityQueue<K, V> tmp(queue);
+        PriorityQueue tmp(queue);
         this->swap(tmp);
         return *this;
     }
 
-    PriorityQueue<K, V>& operator=(PriorityQueue<K, V>&& queue) noexcept(true) {
+    PriorityQueue& operator=(PriorityQueue&& queue) noexcept(true) {
+        this->alloc = std::move(queue.alloc);
+        this->kcomp = queue.kcomp;
+        this->vcomp = queue.vcomp;
+        this->vkcomp = queue.vkcomp;
         this->sorted_by_value = std::move(queue.sorted_by_value);
         this->sorted_by_key = std::move(queue.sorted_by_key);
         this->all_values = std::move(queue.all_values);
+        this->counters = queue.counters;
+        this->content_hash = queue.content_hash;
         return *this;
     }
 
+    // Alokator kolejki [O(1)]
+    allocator_type get_allocator() const { return alloc; }
+
     // Metoda zwracająca true wtedy i tylko wtedy, gdy kolejka jest pusta [O(1)]
     bool empty() const noexcept { return sorted_by_value.empty(); }
 
@@ -133,50 +798,351 @@ class PriorityQueue {
     // [O(1)]
     size_type size() const noexcept { return sorted_by_value.size(); }
 
+    // Wskaźniki strukturalne [O(1)], dostępne niezależnie od collect_stats:
+    // liczba różnych kluczy oraz średnia liczba par na klucz (rozgałęzienie
+    // sorted_by_key). Fan-out bliski 1 oznacza, że środkowy poziom indeksu
+    // klucza jest czystym narzutem.
+    size_type distinctKeys() const noexcept {
+        static_assert(!min_only,
+                      "distinctKeys() requires the key index, absent in a "
+                      "MinOnly queue");
+        return sorted_by_key.size();
+    }
+    double averageKeyFanout() const noexcept {
+        static_assert(!min_only,
+                      "averageKeyFanout() requires the key index, absent in a "
+                      "MinOnly queue");
+        return sorted_by_key.empty()
+                   ? 0.0
+                   : static_cast<double>(size()) / sorted_by_key.size();
+    }
+
+    // Szacunkowy koszt pamięci kolejki w bajtach [O(size())]: węzły każdego
+    // indeksu razy przybliżony rozmiar węzła (payload plus wskaźniki drzewa
+    // czerwono-czarnego), a dla kluczy i wartości trzymanych poza miejscem
+    // dodatkowo blok shared_ptr na każdy odrębny box. To szacunek do
+    // planowania pojemności, nie pomiar co do bajta - luz alokatora
+    // i nagłówki malloca zostają poza rachunkiem.
+    size_type memoryUsage() const {
+        // Węzeł drzewa: payload + rodzic, dwoje dzieci i kolor (z wyrównaniem).
+        constexpr size_type tree_link = 4 * sizeof(void*);
+        // make_shared: licznik odwołań i deleter obok obiektu.
+        constexpr size_type control_block = 4 * sizeof(void*);
+
+        size_type bytes = sizeof(PriorityQueue);
+
+        if constexpr (flat_value_index) {
+            bytes += sorted_by_value.capacity() * sizeof(element);
+            if constexpr (dedup_values)
+                bytes += all_values.capacity() * sizeof(value_ptr);
+        } else {
+            bytes += sorted_by_value.size() * (sizeof(element) + tree_link);
+            if constexpr (dedup_values)
+                bytes += all_values.size() * (sizeof(value_ptr) + tree_link);
+        }
+
+        size_type key_boxes = size();
+        size_type value_boxes = size();
+        if constexpr (!min_only) {
+            key_boxes = sorted_by_key.size();
+            bytes += sorted_by_key.size() *
+                     (sizeof(typename key_map::value_type) + tree_link);
+            size_type buckets = 0;
+            for (const auto& kentry : sorted_by_key)
+                buckets += kentry.second.size();
+            bytes += buckets *
+                     (sizeof(typename value_map::value_type) + tree_link);
+            // kubełki element_set: po jednym węźle na parę
+            bytes += size() * (sizeof(element) + tree_link);
+
+            if constexpr (dedup_values) {
+                // Odrębne boxy wartości to liczba serii równych wartości
+                // w all_values (równe wartości dzielą jeden box).
+                value_boxes = 0;
+                const value_ptr* prev = nullptr;
+                for (const value_ptr& v : all_values) {
+                    if (prev == nullptr || vcomp(*prev, v)) ++value_boxes;
+                    prev = &v;
+                }
+            }
+        }
+
+        if constexpr (!pq_detail::use_inline_storage<K>)
+            bytes += key_boxes * (sizeof(K) + control_block);
+        if constexpr (!pq_detail::use_inline_storage<V>)
+            bytes += value_boxes * (sizeof(V) + control_block);
+
+        return bytes;
+    }
+
+    // Skumulowane liczniki operacji [O(1)]; dostępne tylko przy polityce
+    // z collect_stats (np. WithStats) - bez niej to błąd kompilacji, a nie
+    // cichy zestaw zer
+    const PriorityQueueStats& stats() const {
+        static_assert(Features::collect_stats,
+                      "stats() requires a Features policy with collect_stats");
+        return counters;
+    }
+
+    void resetStats() {
+        static_assert(Features::collect_stats,
+                      "resetStats() requires a Features policy with collect_stats");
+        counters = PriorityQueueStats();
+    }
+
     // Metoda wstawiająca do kolejki parę o kluczu key i wartości value
     // [O(log size())] (dopuszczamy możliwość występowania w kolejce wielu
-    // par o tym samym kluczu)
-    void insert(const K& key, const V& value) {
+    // par o tym samym kluczu); zwraca uchwyt do wpisu klucza, przyjmowany
+    // przez changeValue(handle, value). Warianty z K&&/V&& przenoszą
+    // argument do boxa zamiast go kopiować (a i to dopiero, gdy sonda
+    // w find_element chybi) - przy ciężkich wartościach oddanych przez
+    // std::move enqueue nie płaci za kopię.
+    handle insert(const K& key, const V& value) {
+        return insert_element(key, value);
+    }
+    handle insert(const K& key, V&& value) {
+        return insert_element(key, std::move(value));
+    }
+    handle insert(K&& key, const V& value) {
+        return insert_element(std::move(key), value);
+    }
+    handle insert(K&& key, V&& value) {
+        return insert_element(std::move(key), std::move(value));
+    }
+
+    // Konstrukcja K i V wprost z argumentów (np. emplace(7, 2048, 'x')
+    // dla V = std::string); zmaterializowane obiekty są dalej przenoszone,
+    // więc jedyna kopia to ta wykonana przez konstruktor [O(log size())]
+    template <typename KArg, typename... VArgs>
+    handle emplace(KArg&& karg, VArgs&&... vargs) {
+        return insert_element(K(std::forward<KArg>(karg)),
+                              V(std::forward<VArgs>(vargs)...));
+    }
+
+    // Wstawianie paczki par naraz [O(size() + m log m + m log(size() + m)),
+    // gdzie m to rozmiar paczki]; paczka jest sortowana raz po (wartość,
+    // klucz), a posortowany przebieg wchodzi do sorted_by_value i all_values
+    // wstawianiem z podpowiedzią - zamortyzowane O(1) na element zamiast
+    // O(log n). Silna gwarancja: budujemy na kopii i podmieniamy na końcu
+    // (jak w merge()).
+    void insert(std::vector<std::pair<K, V>>&& batch) {
+        if (batch.empty()) return;
+
+        std::sort(batch.begin(), batch.end(),
+                  [this](std::pair<K, V>& lhs, std::pair<K, V>& rhs) {
+                      if (vcomp(lhs.second, rhs.second)) return true;
+                      if (vcomp(rhs.second, lhs.second)) return false;
+                      return kcomp(lhs.first, rhs.first);
+                  });
+
+        insert_sorted_run(std::move(batch));
+    }
+
+   protected:
+    // Wspólny budowniczy dla insert(paczka) i deserialize(): przebieg musi
+    // być już posortowany po (wartość, klucz).
+    void insert_sorted_run(std::vector<std::pair<K, V>>&& batch) {
         using std::make_pair;
-        using std::tie;
 
-        key_ptr k;
-        value_ptr v;
-        tie(k, v) = find_element(key, value);
+        PriorityQueue tmp = *this;
 
-        auto pair_by_value = make_pair(k, v);
+        auto hint1 = tmp.sorted_by_value.end();
+        auto hint5 = tmp.all_values.end();
+        value_ptr prev_v;
+        bool have_prev = false;
+
+        for (std::pair<K, V>& p : batch) {
+            key_ptr k;
+            if constexpr (min_only) {
+                k = key_ptr::make(std::move(p.first));
+                if constexpr (Features::collect_stats) ++tmp.counters.box_allocs;
+            } else {
+                auto kit0 = tmp.sorted_by_key.find(p.first);
+                k = (kit0 == tmp.sorted_by_key.end())
+                        ? key_ptr::make(std::move(p.first))
+                        : kit0->first;
+            }
+
+            // Paczka jest posortowana po wartości, więc powtórzoną wartość
+            // współdzielimy z poprzednim elementem bez szukania w all_values.
+            value_ptr v;
+            if (have_prev && !vcomp(prev_v, p.second) &&
+                !vcomp(p.second, prev_v)) {
+                v = prev_v;
+                if constexpr (Features::collect_stats)
+                    ++tmp.counters.value_intern_hits;
+            } else {
+                bool interned = false;
+                if constexpr (dedup_values) {
+                    auto vit0 = tmp.all_values.find(p.second);
+                    if (vit0 != tmp.all_values.end()) {
+                        v = *vit0;
+                        interned = true;
+                    }
+                }
+                if (!interned) v = value_ptr::make(std::move(p.second));
+                if constexpr (Features::collect_stats) {
+                    if (interned)
+                        ++tmp.counters.value_intern_hits;
+                    else
+                        ++tmp.counters.box_allocs;
+                }
+            }
+            prev_v = v;
+            have_prev = true;
+
+            auto e = make_pair(k, v);
+            if constexpr (content_hashing)
+                tmp.content_hash += element_hash(*k, *v);
+
+            hint1 = std::next(tmp.sorted_by_value.insert(hint1, e));
+            if constexpr (!min_only) {
+                auto kit =
+                    tmp.sorted_by_key.insert(make_pair(k, tmp.make_value_map()))
+                        .first;
+                auto vit = kit->second.insert(make_pair(v, tmp.make_element_set()))
+                               .first;
+                vit->second.insert(e);
+            }
+            if constexpr (dedup_values)
+                hint5 = std::next(tmp.all_values.insert(hint5, v));
+            if constexpr (Features::collect_stats) ++tmp.counters.inserts;
+        }
+
+        this->swap(tmp);
+    }
+
+   public:
+    // Przeciążenie tylko dla iteratorów po parach - inaczej np.
+    // insert("a", "b") trafiałoby tutaj zamiast do insert(key, value).
+    template <typename InputIt,
+              typename = typename std::enable_if<std::is_convertible<
+                  typename std::iterator_traits<InputIt>::value_type,
+                  std::pair<K, V>>::value>::type>
+    void insert(InputIt first, InputIt last) {
+        insert(std::vector<std::pair<K, V>>(first, last));
+    }
+
+    // Stały, dwukierunkowy iterator po parach w porządku (wartość, klucz) -
+    // czyli dokładnie w kolejności sorted_by_value. Dereferencja daje parę
+    // referencji (const K&, const V&); kolejki nie da się modyfikować przez
+    // iterator. Pełny przegląd to zwykły spacer po drzewie [O(size())],
+    // bez kopiowania kolejki i bez jej opróżniania.
+    class const_iterator {
+        friend class PriorityQueue;
+        typename elements::const_iterator it;
+        explicit const_iterator(typename elements::const_iterator it)
+            : it(it) {}
+
+       public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<const K&, const V&>;
+        using reference = std::pair<const K&, const V&>;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return reference(*(it->first), *(it->second));
+        }
+        const_iterator& operator++() {
+            ++it;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++it;
+            return old;
+        }
+        const_iterator& operator--() {
+            --it;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            --it;
+            return old;
+        }
+        friend bool operator==(const const_iterator& lhs,
+                               const const_iterator& rhs) {
+            return lhs.it == rhs.it;
+        }
+        friend bool operator!=(const const_iterator& lhs,
+                               const const_iterator& rhs) {
+            return lhs.it != rhs.it;
+        }
+    };
 
-        // Iteratory
-        typename elements::iterator it1;
-        typename key_map::iterator it2;
-        typename value_map::iterator it3;
-        typename element_set<>::iterator it4;
-        typename value_set::iterator it5;
+    const_iterator begin() const noexcept {
+        return const_iterator(sorted_by_value.begin());
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(sorted_by_value.end());
+    }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
 
-        bool al1 = false, al2 = false, al3 = false, al4 = false, al5 = false;
+    // Wariant wizytora: fn(const K&, const V&) dla każdej pary w porządku
+    // rosnących wartości [O(size())]
+    template <typename Fn>
+    void for_each_ordered(Fn&& fn) const {
+        for (const element& e : sorted_by_value)
+            fn(static_cast<const K&>(*(e.first)),
+               static_cast<const V&>(*(e.second)));
+    }
 
-        // Polegamy na silnej gwarancji kontenerów STL (map, set)
-        try {
-            it1 = sorted_by_value.insert(pair_by_value);
-            al1 = true;
+    // Migawka binarna: liczba elementów (uint64), po niej surowe pary (K, V)
+    // w porządku sorted_by_value. Format natywny (bez konwersji porządku
+    // bajtów), stąd wymóg trywialnie kopiowalnych K i V. Parametryzowane
+    // typem strumienia (std::ostream/std::istream lub cokolwiek z
+    // write/read), żeby nagłówek nie ciągnął <iostream>.
+    template <typename Stream>
+    void serialize(Stream& os) const {
+        static_assert(std::is_trivially_copyable<K>::value &&
+                          std::is_trivially_copyable<V>::value,
+                      "binary snapshot requires trivially copyable K and V");
 
-            tie(it2, al2) = sorted_by_key.insert(make_pair(k, value_map()));
+        std::uint64_t count = size();
+        os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const element& e : sorted_by_value) {
+            os.write(reinterpret_cast<const char*>(&*e.first), sizeof(K));
+            os.write(reinterpret_cast<const char*>(&*e.second), sizeof(V));
+        }
+    }
 
-            tie(it3, al3) = it2->second.insert(make_pair(v, element_set<>()));
+    // Zastępuje zawartość kolejki migawką ze strumienia. Elementy są zapisane
+    // w porządku (wartość, klucz), więc wszystkie trzy indeksy odtwarzamy
+    // hintowanym przebiegiem z insert_sorted_run - zamortyzowane O(1) na
+    // element w sorted_by_value/all_values, z odtworzeniem współdzielenia
+    // wskaźników, zamiast pięciu pełnych wstawień na parę.
+    template <typename Stream>
+    void deserialize(Stream& is) {
+        static_assert(std::is_trivially_copyable<K>::value &&
+                          std::is_trivially_copyable<V>::value,
+                      "binary snapshot requires trivially copyable K and V");
 
-            it4 = it3->second.insert(pair_by_value);
-            al4 = true;
+        std::uint64_t count = 0;
+        is.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!is) throw PriorityQueueSnapshotException();
 
-            it5 = all_values.insert(v);
-            al5 = true;
-        } catch (...) {
-            if (al5) all_values.erase(it5);
-            if (al4) it3->second.erase(it4);
-            if (al3) it2->second.erase(it3);
-            if (al2) sorted_by_key.erase(it2);
-            if (al1) sorted_by_value.erase(it1);
-            throw;
+        // Nagłówkowi nie ufamy na tyle, żeby alokować count par z góry:
+        // paczka rośnie w miarę faktycznie wczytanych danych, więc ucięta
+        // albo przekłamana migawka kończy się wyjątkiem, a nie gigantyczną
+        // alokacją z 64-bitowego śmiecia. Kolejka zostaje nietknięta -
+        // podmiana dopiero po wczytaniu całości (silna gwarancja).
+        std::vector<std::pair<K, V>> batch;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::pair<K, V> p;
+            is.read(reinterpret_cast<char*>(&p.first), sizeof(K));
+            is.read(reinterpret_cast<char*>(&p.second), sizeof(V));
+            if (!is) throw PriorityQueueSnapshotException();
+            batch.push_back(p);
         }
+
+        PriorityQueue fresh = empty_clone();
+        fresh.insert_sorted_run(std::move(batch));
+        this->swap(fresh);
     }
 
     // Metody zwracające odpowiednio najmniejszą i największą wartość
@@ -205,127 +1171,507 @@ class PriorityQueue {
         return *(sorted_by_value.rbegin()->first);
     }
 
+    // Odczyty po kluczu, wprost z sorted_by_key - ten indeks i tak jest
+    // utrzymywany przy każdej modyfikacji, więc wołający nie musi trzymać
+    // obok kolejki własnej mapy klucz->wartość.
+
+    // Czy w kolejce jest jakakolwiek para o kluczu key [O(log size())]
+    bool contains(const K& key) const {
+        static_assert(!min_only,
+                      "contains() requires the key index, absent in a "
+                      "MinOnly queue");
+        return sorted_by_key.find(key) != sorted_by_key.end();
+    }
+
+    // Liczba par o kluczu key [O(log size() + b), gdzie b to liczba
+    // różnych wartości pod tym kluczem]
+    size_type count(const K& key) const {
+        static_assert(!min_only,
+                      "count() requires the key index, absent in a "
+                      "MinOnly queue");
+        auto kit = sorted_by_key.find(key);
+        if (kit == sorted_by_key.end()) return 0;
+        size_type n = 0;
+        for (const auto& ventry : kit->second) n += ventry.second.size();
+        return n;
+    }
+
+    // Jedna z wartości przypisanych kluczowi key - najmniejsza, czyli ta,
+    // którą wybrałyby changeValue()/erase() [O(log size())]; brak klucza
+    // zgłasza PriorityQueueNotFoundException
+    const V& anyValueFor(const K& key) const {
+        static_assert(!min_only,
+                      "anyValueFor() requires the key index, absent in a "
+                      "MinOnly queue");
+        auto kit = sorted_by_key.find(key);
+        if (kit == sorted_by_key.end()) throw PriorityQueueNotFoundException();
+        return *(kit->second.begin()->first);
+    }
+
+    // Wizytor fn(const V&) po wszystkich wartościach klucza key w porządku
+    // rosnącym, z powtórzeniami [O(log size() + k)]
+    template <typename Fn>
+    void for_each_value(const K& key, Fn&& fn) const {
+        static_assert(!min_only,
+                      "for_each_value() requires the key index, absent in a "
+                      "MinOnly queue");
+        auto kit = sorted_by_key.find(key);
+        if (kit == sorted_by_key.end()) return;
+        for (const auto& ventry : kit->second)
+            for (size_type i = ventry.second.size(); i > 0; --i)
+                fn(static_cast<const V&>(*(ventry.first)));
+    }
+
+   protected:
+    // Usuwa element wskazywany przez it ze wszystkich trzech indeksów
+    // [O(log size())]. Najpierw same wyszukiwania (mogą rzucić, ale niczego
+    // jeszcze nie zmieniają), potem wyłącznie nierzucające erase po
+    // iteratorach - stąd silna gwarancja.
+    void erase_element(typename elements::iterator it) {
+        const element& e = *it;
+        if constexpr (content_hashing)
+            content_hash -= element_hash(*(e.first), *(e.second));
+
+        if constexpr (!min_only) {
+            auto kit = sorted_by_key.find(e.first);
+            assert(kit != sorted_by_key.end());
+            auto vit = kit->second.find(e.second);
+            assert(vit != kit->second.end());
+            auto ait = vit->second.begin();
+            assert(ait != vit->second.end());
+
+            typename value_set::iterator bit;
+            if constexpr (dedup_values) {
+                bit = all_values.find(e.second);
+                assert(bit != all_values.end());
+            }
+
+            // Modyfikacje
+            vit->second.erase(ait);
+            if (vit->second.empty()) kit->second.erase(vit);
+            if (kit->second.empty()) sorted_by_key.erase(kit);
+            if constexpr (dedup_values) all_values.erase(bit);
+        }
+        sorted_by_value.erase(it);
+
+        if constexpr (Features::collect_stats) ++counters.deletes;
+    }
+
+    // Odpina span [first, last) z sorted_by_value od pozostałych indeksów;
+    // samego sorted_by_value nie rusza, więc wołający może potem wyciąć go
+    // jednym erase(first, last). Na całej paczce to 3-4 operacje drzewiaste
+    // na element zamiast 5 i pojedyncze cięcie spanu zamiast k erase'ów.
+    // Gwarancja podstawowa: porównanie rzucone w środku zostawia część
+    // paczki już odpiętą (indeksy pozostają spójne z wyciętym prefiksem).
+    void detach_span(typename elements::iterator first,
+                     typename elements::iterator last) {
+        for (auto it = first; it != last; ++it) {
+            const element& e = *it;
+            if constexpr (content_hashing)
+                content_hash -= element_hash(*(e.first), *(e.second));
+            if constexpr (!min_only) {
+                auto kit = sorted_by_key.find(e.first);
+                assert(kit != sorted_by_key.end());
+                auto vit = kit->second.find(e.second);
+                assert(vit != kit->second.end());
+                vit->second.erase(vit->second.begin());
+                if (vit->second.empty()) kit->second.erase(vit);
+                if (kit->second.empty()) sorted_by_key.erase(kit);
+            }
+            if constexpr (dedup_values) {
+                auto bit = all_values.find(e.second);
+                assert(bit != all_values.end());
+                all_values.erase(bit);
+            }
+            if constexpr (Features::collect_stats) ++counters.deletes;
+        }
+    }
+
+    // Usuwa element i oddaje jego zawartość. Dla typów przenoszalnych bez
+    // wyjątków zawartość jest przenoszona, gdy nikt jej już nie współdzieli
+    // (kopiowanie tylko przy współdzielonych kluczach/wartościach); dla
+    // pozostałych typów para jest kopiowana przed usunięciem, co zachowuje
+    // silną gwarancję.
+    std::pair<K, V> pop_element(typename elements::iterator it) {
+        key_ptr k = it->first;
+        value_ptr v = it->second;
+
+        if constexpr (std::is_nothrow_move_constructible<K>::value &&
+                      std::is_nothrow_move_constructible<V>::value) {
+            erase_element(it);
+            return std::pair<K, V>(
+                k.use_count() == 1 ? std::move(*k) : *k,
+                v.use_count() == 1 ? std::move(*v) : *v);
+        } else {
+            std::pair<K, V> result(*k, *v);
+            erase_element(it);
+            return result;
+        }
+    }
+
+   public:
     // Metody usuwające z kolejki jedną parę o odpowiednio najmniejszej lub
     // największej wartości [O(log size())]
     void deleteMin() {
         if (empty()) return;
-        const element& e = *(sorted_by_value.begin());
-        value_ptr v = e.second;
-
-        auto kit = sorted_by_key.find(e.first);
-        assert(kit != sorted_by_key.end());
-        auto vit = kit->second.find(e.second);
-        assert(vit != kit->second.end());
-        auto ait = vit->second.begin();
-        assert(ait != vit->second.end());
-        auto bit = all_values.find(e.second);
-        assert(bit != all_values.end());
-
-        // Modyfikacje
-        vit->second.erase(ait);
-        if (vit->second.empty()) kit->second.erase(vit);
-        if (kit->second.empty()) sorted_by_key.erase(kit);
-        sorted_by_value.erase(sorted_by_value.begin());
-        all_values.erase(bit);
+        erase_element(sorted_by_value.begin());
     }
 
     void deleteMax() {
         if (empty()) return;
-        const element& e = *prev(sorted_by_value.end());
-        value_ptr v = e.second;
-
-        auto kit = sorted_by_key.find(e.first);
-        assert(kit != sorted_by_key.end());
-        auto vit = kit->second.find(e.second);
-        assert(vit != kit->second.end());
-        auto ait = vit->second.begin();
-        assert(ait != vit->second.end());
-        auto bit = all_values.find(e.second);
-        assert(bit != all_values.end());
-
-        // Modyfikacje
-        vit->second.erase(ait);
-        if (vit->second.empty()) kit->second.erase(vit);
-        if (kit->second.empty()) sorted_by_key.erase(kit);
-        sorted_by_value.erase(prev(sorted_by_value.end()));
-        all_values.erase(bit);
+        erase_element(prev(sorted_by_value.end()));
     }
 
-    // Metoda zmieniająca dotychczasową wartość przypisaną kluczowi key na nową
-    // wartość value [O(log size())]; w przypadku gdy w kolejce nie ma pary
-    // o kluczu key, powinien zostać zgłoszony wyjątek
-    // PriorityQueueNotFoundException(); w przypadku kiedy w kolejce jest kilka
-    // par
-    // o kluczu key, zmienia wartość w dowolnie wybranej parze o podanym kluczu
-    void changeValue(const K& key, const V& value) {
+    // Warianty usuwające, które oddają usuniętą parę bez ponownych wyszukiwań
+    // minKey()/minValue() po stronie wołającego [O(log size())]
+    std::pair<K, V> popMin() {
+        if (empty()) throw PriorityQueueEmptyException();
+        return pop_element(sorted_by_value.begin());
+    }
+
+    std::pair<K, V> popMax() {
+        if (empty()) throw PriorityQueueEmptyException();
+        return pop_element(prev(sorted_by_value.end()));
+    }
+
+    // Wariant bez wyjątku dla pustej kolejki: zwraca false zamiast rzucać
+    bool tryPopMin(K& key, V& value) {
+        if (empty()) return false;
+        std::pair<K, V> result = pop_element(sorted_by_value.begin());
+        key = std::move(result.first);
+        value = std::move(result.second);
+        return true;
+    }
+
+   protected:
+    // Wspólny rdzeń popMinN/popMaxN: oddaje zawartość spanu [first, last)
+    // w wektorze i usuwa go z kolejki - jedno przejście po sorted_by_value,
+    // odpięcie pozostałych indeksów przez detach_span i jedno cięcie spanu.
+    // Przenoszenie/kopiowanie jak w pop_element; w wariancie przenoszącym
+    // gwarancja podstawowa (jak w detach_span).
+    std::vector<std::pair<K, V>> pop_span(typename elements::iterator first,
+                                          typename elements::iterator last) {
+        std::vector<std::pair<K, V>> out;
+        out.reserve(std::distance(first, last));
+
+        if constexpr (std::is_nothrow_move_constructible<K>::value &&
+                      std::is_nothrow_move_constructible<V>::value) {
+            // Po odpięciu boxy spanu należą już tylko do sorted_by_value
+            // (i do par dzielących klucz/wartość), więc ostatni właściciel
+            // może oddać zawartość przeniesieniem.
+            detach_span(first, last);
+            for (auto it = first; it != last; ++it)
+                out.emplace_back(
+                    it->first.use_count() == 1 ? std::move(*(it->first))
+                                               : *(it->first),
+                    it->second.use_count() == 1 ? std::move(*(it->second))
+                                                : *(it->second));
+        } else {
+            // Kopie przed mutacją, jak w pop_element dla typów rzucających.
+            for (auto it = first; it != last; ++it)
+                out.emplace_back(*(it->first), *(it->second));
+            detach_span(first, last);
+        }
+        sorted_by_value.erase(first, last);
+        return out;
+    }
+
+   public:
+    // Zdejmuje naraz min(k, size()) par o najmniejszych wartościach,
+    // w porządku rosnącym [O(k log size())]. Jedno przejście po
+    // sorted_by_value zamiast k rund minKey()/minValue()/deleteMin(),
+    // z których każda startowała od begin() i powtarzała wyszukiwania
+    // w pozostałych indeksach.
+    std::vector<std::pair<K, V>> popMinN(size_type k) {
+        if (k > size()) k = size();
+        auto last = std::next(sorted_by_value.begin(), k);
+        return pop_span(sorted_by_value.begin(), last);
+    }
+
+    // Jak popMinN, ale od strony największych wartości; pary wracają
+    // w porządku zdejmowania, czyli malejącym - jak k rund popMax()
+    std::vector<std::pair<K, V>> popMaxN(size_type k) {
+        if (k > size()) k = size();
+        auto first = std::prev(sorted_by_value.end(), k);
+        auto out = pop_span(first, sorted_by_value.end());
+        std::reverse(out.begin(), out.end());
+        return out;
+    }
+
+   protected:
+    // Wspólna część changeValue: przepięcie jednej pary spod wpisu kit na
+    // nową wartość [O(log size())], silna gwarancja jak w insert().
+    void change_value_at(typename key_map::iterator kit, const V& value) {
         using std::make_pair;
         using std::tie;
 
-        key_ptr k;
+        key_ptr k = kit->first;
         value_ptr v;
-        tie(k, v) = find_element(key, value);
+        if constexpr (dedup_values) {
+            auto vit0 = all_values.find(value);
+            v = (vit0 == all_values.end()) ? value_ptr::make(value) : *vit0;
+            if constexpr (Features::collect_stats) {
+                if (vit0 == all_values.end())
+                    ++counters.box_allocs;
+                else
+                    ++counters.value_intern_hits;
+            }
+        } else {
+            v = value_ptr::make(value);
+            if constexpr (Features::collect_stats) ++counters.box_allocs;
+        }
+
+        value_ptr old = kit->second.begin()->first;
+
+        auto pair_by_value = make_pair(k, v);
+
+        if constexpr (!flat_value_index && nothrow_fast_path &&
+                      std::allocator_traits<Allocator>::is_always_equal::value) {
+            // Relokacja istniejących węzłów (node handles z C++17) zamiast
+            // wstawienia i czterech usunięć: po jednym extract + insert na
+            // indeks, węzły są używane ponownie, a drzewo przebudowuje się
+            // tylko tam, gdzie pozycja faktycznie się zmienia. Jedyna
+            // możliwa alokacja to kubełek value_map dla nowej wartości.
+            // Tylko dla typów bez rzucających porównań (nothrow_fast_path):
+            // wyjątek między extract a insert gubiłby element. I tylko dla
+            // alokatorów bezstanowych: libstdc++ przy ponownym wstawieniu
+            // węzła zeruje uchwyt bez zwolnienia trzymanej kopii alokatora,
+            // więc każda relokacja gubiłaby np. referencję do areny
+            // PoolAllocatora - wewnątrz pamięci węzła tej samej areny,
+            // czyli cykl przypinający całą arenę.
+            auto nh1 = sorted_by_value.extract(make_pair(k, old));
+            assert(!nh1.empty());
+            nh1.value().second = v;
+            sorted_by_value.insert(std::move(nh1));
+
+            auto vit = kit->second.find(old);
+            assert(vit != kit->second.end());
+            auto nh2 = vit->second.extract(vit->second.begin());
+            nh2.value().second = v;
+            auto it3 =
+                kit->second.insert(make_pair(v, make_element_set())).first;
+            it3->second.insert(std::move(nh2));
+            if (vit->second.empty()) kit->second.erase(vit);
+
+            if constexpr (dedup_values) {
+                auto nh3 = all_values.extract(old);
+                assert(!nh3.empty());
+                nh3.value() = v;
+                all_values.insert(std::move(nh3));
+            }
+        } else if constexpr (nothrow_fast_path) {
+            // Płaski backend nie ma extract; prostoliniowa wersja bez
+            // wycofywania (patrz nothrow_fast_path): wstaw nową parę,
+            // potem usuń starą.
+            sorted_by_value.insert(pair_by_value);
+            auto it3 =
+                kit->second.insert(make_pair(v, make_element_set())).first;
+            it3->second.insert(pair_by_value);
+            if constexpr (dedup_values) all_values.insert(v);
+
+            sorted_by_value.erase(sorted_by_value.find(make_pair(k, old)));
+            if constexpr (dedup_values)
+                all_values.erase(all_values.find(old));
+            auto vit = kit->second.find(old);
+            assert(vit != kit->second.end());
+            vit->second.erase(vit->second.begin());
+            if (vit->second.size() == 0) kit->second.erase(vit);
+        } else {
+            auto itr_e1 = sorted_by_value.find(make_pair(k, old));
+            typename value_set::iterator itr_e2;
+            if constexpr (dedup_values) itr_e2 = all_values.find(old);
+            auto vit = kit->second.find(old);
+            assert(vit != kit->second.end());
+
+            // Wstawmy najpierw nową parę...
+
+            // Iterators
+            typename elements::iterator it1;
+            typename key_map::iterator it2;
+            typename value_map::iterator it3;
+            typename element_set<>::iterator it4;
+            typename value_set::iterator it5;
+            // If we have to remove them on fail.
+            bool al1 = false, al2 = false, al3 = false, al4 = false,
+                 al5 = false;
+            // Polegamy na silnej gwarancji kontenerów STL (map, set)
+            try {
+                it1 = sorted_by_value.insert(pair_by_value);
+                al1 = true;
+
+                tie(it2, al2) =
+                    sorted_by_key.insert(make_pair(k, make_value_map()));
+
+                tie(it3, al3) =
+                    it2->second.insert(make_pair(v, make_element_set()));
+
+                it4 = it3->second.insert(pair_by_value);
+                al4 = true;
+
+                if constexpr (dedup_values) {
+                    it5 = all_values.insert(v);
+                    al5 = true;
+                }
+            } catch (...) {
+                if (al5) all_values.erase(it5);
+                if (al4) it3->second.erase(it4);
+                if (al3) it2->second.erase(it3);
+                if (al2) sorted_by_key.erase(it2);
+                if (al1) sorted_by_value.erase(it1);
+                throw;
+            }
+            // A teraz usuńmy starą
+            if constexpr (flat_value_index) {
+                // Wstawienie do płaskiego indeksu unieważniło iteratory
+                // sprzed try, więc stare wpisy znajdujemy jeszcze raz (gdyby
+                // to porównanie rzuciło, nowa para już została - stąd tylko
+                // podstawowa gwarancja w tym trybie).
+                itr_e1 = sorted_by_value.find(make_pair(k, old));
+                if constexpr (dedup_values) itr_e2 = all_values.find(old);
+            }
+            sorted_by_value.erase(itr_e1);
+            if constexpr (dedup_values) all_values.erase(itr_e2);
+            vit->second.erase(vit->second.begin());
+            if (vit->second.size() == 0) kit->second.erase(vit);
+        }
+
+        if constexpr (content_hashing) {
+            content_hash -= element_hash(*k, *old);
+            content_hash += element_hash(*k, *v);
+        }
+        if constexpr (Features::collect_stats) ++counters.change_values;
+    }
+
+   protected:
+    // Usuwa jedną parę o dokładnie tym kluczu i tej wartości [O(log size())];
+    // false, gdy takiej pary nie ma. Używane przez rozszerzenia (np. tryb
+    // TTL), które muszą trafić konkretną parę, a nie dowolną spod klucza.
+    bool erase_pair(const K& key, const V& value) {
+        static_assert(!min_only,
+                      "erase_pair() requires the key index, absent in a "
+                      "MinOnly queue");
+        auto kit = sorted_by_key.find(key);
+        if (kit == sorted_by_key.end()) return false;
+        auto vit = kit->second.find(value);
+        if (vit == kit->second.end()) return false;
+
+        auto it = sorted_by_value.find(std::make_pair(kit->first, vit->first));
+        assert(it != sorted_by_value.end());
+        erase_element(it);
+        return true;
+    }
+
+   public:
+    // Usuwa z kolejki jedną parę o kluczu key [O(log size())]; zwraca false,
+    // gdy klucza nie ma (anulowanie może się ścigać z pop, więc brak klucza
+    // nie jest tu błędem). Przy kilku parach o tym samym kluczu usuwana jest
+    // dowolnie wybrana - jak w changeValue()
+    bool erase(const K& key) {
+        static_assert(!min_only,
+                      "erase(key) requires the key index, absent in a "
+                      "MinOnly queue");
+        auto kit = sorted_by_key.find(key);
+        if (kit == sorted_by_key.end()) return false;
+
+        value_ptr old = kit->second.begin()->first;
+        auto it = sorted_by_value.find(std::make_pair(kit->first, old));
+        assert(it != sorted_by_value.end());
+        erase_element(it);
+        return true;
+    }
 
-        auto kit = sorted_by_key.find(k);
+    // Jak erase(), ale oddaje usuniętą parę; brak klucza zgłasza
+    // PriorityQueueNotFoundException [O(log size())]
+    std::pair<K, V> extract(const K& key) {
+        static_assert(!min_only,
+                      "extract() requires the key index, absent in a "
+                      "MinOnly queue");
+        auto kit = sorted_by_key.find(key);
         if (kit == sorted_by_key.end()) throw PriorityQueueNotFoundException();
 
         value_ptr old = kit->second.begin()->first;
+        auto it = sorted_by_value.find(std::make_pair(kit->first, old));
+        assert(it != sorted_by_value.end());
+        return pop_element(it);
+    }
 
-        auto itr_e1 = sorted_by_value.find(make_pair(k, old));
-        auto itr_e2 = all_values.find(old);
-        auto vit = kit->second.find(old);
-        assert(vit != kit->second.end());
+    // Liczba par o wartości w przedziale [lo, hi) [O(log size() + k)];
+    // dwa lower_bound po samym V (przezroczysty ValueKeyComparer), bez
+    // dotykania pozostałych indeksów
+    size_type countValueRange(const V& lo, const V& hi) const {
+        if (!vcomp(lo, hi)) return 0;
+        return std::distance(sorted_by_value.lower_bound(lo),
+                             sorted_by_value.lower_bound(hi));
+    }
 
-        // Wstawmy najpierw nową parę...
+    // Usuwa wszystkie pary o wartości mniejszej od bound i zwraca ich
+    // liczbę [O(log size() + k log size())]. Jedno cięcie prefiksu
+    // sorted_by_value zamiast pętli deleteMin() - typowy przebieg
+    // wygaszania timerów. Gwarancja podstawowa (jak w detach_span)
+    size_type eraseValuesBelow(const V& bound) {
+        auto last = sorted_by_value.lower_bound(bound);
+        size_type count = std::distance(sorted_by_value.begin(), last);
+        if (count == 0) return 0;
 
-        auto pair_by_value = make_pair(k, v);
+        detach_span(sorted_by_value.begin(), last);
+        sorted_by_value.erase(sorted_by_value.begin(), last);
+        return count;
+    }
+
+    // Jak wyżej, ale dla przedziału [lo, hi) i z oddaniem usuniętych par
+    // w porządku rosnących wartości
+    std::vector<std::pair<K, V>> extractValueRange(const V& lo, const V& hi) {
+        std::vector<std::pair<K, V>> out;
+        if (!vcomp(lo, hi)) return out;
+
+        auto first = sorted_by_value.lower_bound(lo);
+        auto last = sorted_by_value.lower_bound(hi);
+        // Kopie przed mutacją: jak w pop_element dla typów rzucających.
+        out.reserve(std::distance(first, last));
+        for (auto it = first; it != last; ++it)
+            out.emplace_back(*(it->first), *(it->second));
+
+        detach_span(first, last);
+        sorted_by_value.erase(first, last);
+        return out;
+    }
+
+    // Metoda zmieniająca dotychczasową wartość przypisaną kluczowi key na nową
+    // wartość value [O(log size())]; w przypadku gdy w kolejce nie ma pary
+    // o kluczu key, powinien zostać zgłoszony wyjątek
+    // PriorityQueueNotFoundException(); w przypadku kiedy w kolejce jest kilka
+    // par
+    // o kluczu key, zmienia wartość w dowolnie wybranej parze o podanym kluczu
+    void changeValue(const K& key, const V& value) {
+        static_assert(!min_only,
+                      "changeValue() requires the key index, absent in a "
+                      "MinOnly queue");
+        auto kit = sorted_by_key.find(key);
+        if (kit == sorted_by_key.end()) throw PriorityQueueNotFoundException();
+        change_value_at(kit, value);
+    }
 
-        // Iterators
-        typename elements::iterator it1;
-        typename key_map::iterator it2;
-        typename value_map::iterator it3;
-        typename element_set<>::iterator it4;
-        typename value_set::iterator it5;
-        // If we have to remove them on fail.
-        bool al1 = false, al2 = false, al3 = false, al4 = false, al5 = false;
-        // Polegamy na silnej gwarancji kontenerów STL (map, set)
-        try {
-            it1 = sorted_by_value.insert(pair_by_value);
-            al1 = true;
-
-            tie(it2, al2) = sorted_by_key.insert(make_pair(k, value_map()));
-
-            tie(it3, al3) = it2->second.insert(make_pair(v, element_set<>()));
-
-            it4 = it3->second.insert(pair_by_value);
-            al4 = true;
-
-            it5 = all_values.insert(v);
-            al5 = true;
-        } catch (...) {
-            if (al5) all_values.erase(it5);
-            if (al4) it3->second.erase(it4);
-            if (al3) it2->second.erase(it3);
-            if (al2) sorted_by_key.erase(it2);
-            if (al1) sorted_by_value.erase(it1);
-            throw;
-        }
-        // A teraz usuńmy starą
-        sorted_by_value.erase(itr_e1);
-        all_values.erase(itr_e2);
-        vit->second.erase(vit->second.begin());
-        if (vit->second.size() == 0) kit->second.erase(vit);
+    // Wariant adresowany uchwytem z insert(): bez wyszukiwania klucza
+    // oszczędzamy O(log size()) porównań na wywołanie - istotne przy
+    // wielokrotnych aktualizacjach tych samych kluczy (decrease-key)
+    void changeValue(const handle& h, const V& value) {
+        static_assert(!min_only,
+                      "changeValue() requires the key index, absent in a "
+                      "MinOnly queue");
+        change_value_at(h.kit, value);
     }
 
     // Metoda scalająca zawartość kolejki z podaną kolejką queue; ta operacja
     // usuwa
     // wszystkie elementy z kolejki queue i wstawia je do kolejki *this
     // [O(size() + queue.size() * log (queue.size() + size()))]
-    void merge(PriorityQueue<K, V>& queue) {
+    void merge(PriorityQueue& queue) {
+        using std::make_pair;
         using std::tie;
 
         if (this == &queue) return;
 
-        PriorityQueue<K, V> merged_queue = *this;
+        PriorityQueue merged_queue = *this;
 
         for (element e : queue.sorted_by_value) {
             key_ptr k;
@@ -333,56 +1679,180 @@ class PriorityQueue {
             tie(k, v) = merged_queue.find_element(e.first, e.second);
 
             merged_queue.sorted_by_value.insert(e);
-            merged_queue.sorted_by_key[k][v].insert(e);
-            merged_queue.all_values.insert(v);
+            if constexpr (!min_only) {
+                // Nie używamy operator[], bo zagnieżdżone kontenery muszą
+                // dostać alokator kolejki docelowej.
+                auto kit =
+                    merged_queue.sorted_by_key
+                        .insert(make_pair(k, merged_queue.make_value_map()))
+                        .first;
+                auto vit =
+                    kit->second
+                        .insert(make_pair(v, merged_queue.make_element_set()))
+                        .first;
+                vit->second.insert(e);
+                if constexpr (dedup_values) merged_queue.all_values.insert(v);
+            }
         }
+        if constexpr (content_hashing)
+            merged_queue.content_hash += queue.content_hash;
         queue.sorted_by_value.clear();
         queue.sorted_by_key.clear();
         queue.all_values.clear();
+        if constexpr (content_hashing) queue.content_hash = 0;
 
         this->swap(merged_queue);
+        if constexpr (Features::collect_stats) ++counters.merges;
+    }
+
+    // Szybkie, niszczące scalanie: węzły kolejki queue są przepinane
+    // (extract/merge z C++17) wprost do kontenerów *this, bez kopiowania
+    // *this i bez alokacji nowych węzłów
+    // [O(queue.size() * log(size() + queue.size()))], stały koszt pamięci.
+    // W odróżnieniu od merge() dajemy tylko gwarancję podstawową: jeśli
+    // porównanie rzuci w trakcie, część elementów jest już przeniesiona
+    // (obie kolejki pozostają spójne).
+    // Przy alokatorach ze stanem obie kolejki muszą dzielić równy alokator.
+    void mergeFast(PriorityQueue&& queue) {
+        if (this == &queue) return;
+        assert(alloc == queue.alloc || queue.empty());
+
+        sorted_by_value.merge(queue.sorted_by_value);
+        if constexpr (dedup_values) all_values.merge(queue.all_values);
+
+        // map::merge zostawia w źródle wpisy o kluczach już obecnych w celu;
+        // ich zawartość doklejamy przepinając węzły poziom niżej.
+        sorted_by_key.merge(queue.sorted_by_key);
+        if constexpr (!min_only) {
+            for (auto& kentry : queue.sorted_by_key) {
+                auto kit = sorted_by_key.find(kentry.first);
+                assert(kit != sorted_by_key.end());
+                kit->second.merge(kentry.second);
+                for (auto& ventry : kentry.second) {
+                    auto vit = kit->second.find(ventry.first);
+                    assert(vit != kit->second.end());
+                    vit->second.merge(ventry.second);
+                }
+            }
+        }
+        queue.sorted_by_key.clear();
+        if constexpr (content_hashing) {
+            content_hash += queue.content_hash;
+            queue.content_hash = 0;
+        }
+
+        if constexpr (Features::collect_stats) ++counters.merges;
+    }
+
+    // Scala naraz k kolejek przepinaniem węzłów (jak mergeFast), opróżniając
+    // źródła [O(sum_i m_i * log N)]. Zastępuje pętlę parowych merge(), która
+    // w każdej rundzie kopiowała cały akumulator. Koszt przepięcia płaci
+    // mniejsza strona, więc najpierw czynimy celem największą z kolejek.
+    // Wymagania alokatorowe jak w mergeFast().
+    void mergeAll(std::vector<PriorityQueue>&& queues) {
+        auto largest = std::max_element(
+            queues.begin(), queues.end(),
+            [](const PriorityQueue& lhs, const PriorityQueue& rhs) {
+                return lhs.size() < rhs.size();
+            });
+        if (largest != queues.end() && size() < largest->size())
+            this->swap(*largest);
+
+        for (PriorityQueue& q : queues) mergeFast(std::move(q));
+    }
+
+    // Przebudowuje wszystkie indeksy od zera w świeżo alokowanych
+    // kontenerach [O(size())] i oddaje stare węzły alokatorowi jednym
+    // rzutem. Po masowym usuwaniu (np. dziennym purge) zwolnione węzły
+    // drzew wiszą na wolnych listach alokatora i RSS procesu nie spada;
+    // po compact() zostaje dokładnie tyle węzłów, ile jest par - przy
+    // alokatorze arenowym (PoolAllocator) całe stare areny można oddać.
+    // Boxy kluczy i wartości są współdzielone ze starą strukturą, więc
+    // K/V nie są kopiowane. Silna gwarancja: budowa na boku i swap.
+    void compact() {
+        using std::make_pair;
+
+        // empty_clone buduje od razu na alokatorze kolejki: fresh
+        // skonstruowane domyślnie alokowałoby węzły z własnej, tymczasowej
+        // areny, która umiera razem z fresh po końcowym swapie.
+        PriorityQueue fresh = empty_clone();
+
+        // sorted_by_value idzie w porządku (wartość, klucz), więc wstawianie
+        // z podpowiedzią end() jest zamortyzowanym O(1) na element.
+        auto hint1 = fresh.sorted_by_value.end();
+        auto hint5 = fresh.all_values.end();
+        for (const element& e : sorted_by_value) {
+            hint1 = std::next(fresh.sorted_by_value.insert(hint1, e));
+            if constexpr (!min_only) {
+                auto kit = fresh.sorted_by_key
+                               .insert(make_pair(e.first, make_value_map()))
+                               .first;
+                auto vit = kit->second
+                               .insert(make_pair(e.second, make_element_set()))
+                               .first;
+                vit->second.insert(e);
+            }
+            if constexpr (dedup_values)
+                hint5 = std::next(fresh.all_values.insert(hint5, e.second));
+        }
+
+        fresh.counters = counters;
+        fresh.content_hash = content_hash;
+        this->swap(fresh);
     }
 
     // Metoda zamieniającą zawartość kolejki z podaną kolejką queue (tak jak
     // większość kontenerów w bibliotece standardowej) [O(1)]
     // Gwarancja no-throw
-    void swap(PriorityQueue<K, V>& queue) noexcept {
+    void swap(PriorityQueue& queue) noexcept {
         if (this == &queue) return;
+        std::swap(this->alloc, queue.alloc);
+        std::swap(this->kcomp, queue.kcomp);
+        std::swap(this->vcomp, queue.vcomp);
+        std::swap(this->vkcomp, queue.vkcomp);
         this->sorted_by_value.swap(queue.sorted_by_value);
         this->sorted_by_key.swap(queue.sorted_by_key);
         this->all_values.swap(queue.all_values);
+        std::swap(this->counters, queue.counters);
+        std::swap(this->content_hash, queue.content_hash);
     }
 
-    friend void swap(PriorityQueue<K, V>& lhs,
-                     PriorityQueue<K, V>& rhs) noexcept {
+    friend void swap(PriorityQueue& lhs,
+                     PriorityQueue& rhs) noexcept {
         lhs.swap(rhs);
     }
 
-    friend bool operator==(const PriorityQueue<K, V>& lhs,
-                           const PriorityQueue<K, V>& rhs) {
+    // Najpierw tanie odsiewki: rozmiar, potem utrzymywany hasz zawartości
+    // (dla haszowalnych K/V) - dwie różne kolejki prawie zawsze kończą na
+    // dwóch porównaniach liczb; pełny przebieg zostaje dla kolizji haszu
+    friend bool operator==(const PriorityQueue& lhs,
+                           const PriorityQueue& rhs) {
+        if (lhs.size() != rhs.size()) return false;
+        if constexpr (content_hashing)
+            if (lhs.content_hash != rhs.content_hash) return false;
         return lhs.sorted_by_value == rhs.sorted_by_value;
     }
-    friend bool operator!=(const PriorityQueue<K, V>& lhs,
-                           const PriorityQueue<K, V>& rhs) {
-        return lhs.sorted_by_value != rhs.sorted_by_value;
+    friend bool operator!=(const PriorityQueue& lhs,
+                           const PriorityQueue& rhs) {
+        return !(lhs == rhs);
     }
-    friend bool operator<(const PriorityQueue<K, V>& lhs,
-                          const PriorityQueue<K, V>& rhs) {
+    friend bool operator<(const PriorityQueue& lhs,
+                          const PriorityQueue& rhs) {
         return std::lexicographical_compare(
             lhs.sorted_by_value.begin(), lhs.sorted_by_value.end(),
             rhs.sorted_by_value.begin(), rhs.sorted_by_value.end(),
-            ValueKeyComparer());
+            lhs.vkcomp);
     }
-    friend bool operator>(const PriorityQueue<K, V>& lhs,
-                          const PriorityQueue<K, V>& rhs) {
+    friend bool operator>(const PriorityQueue& lhs,
+                          const PriorityQueue& rhs) {
         return rhs < lhs;
     }
-    friend bool operator<=(const PriorityQueue<K, V>& lhs,
-                           const PriorityQueue<K, V>& rhs) {
+    friend bool operator<=(const PriorityQueue& lhs,
+                           const PriorityQueue& rhs) {
         return !(lhs > rhs);
     }
-    friend bool operator>=(const PriorityQueue<K, V>& lhs,
-                           const PriorityQueue<K, V>& rhs) {
+    friend bool operator>=(const PriorityQueue& lhs,
+                           const PriorityQueue& rhs) {
         return !(lhs < rhs);
     }
 };
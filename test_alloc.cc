@@ -0,0 +1,82 @@
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <utility>
+
+#include "priorityqueue.hh"
+#include "poolallocator.hh"
+
+using pooled_queue = PriorityQueue<int, int, PoolAllocator<void>>;
+
+int main() {
+    pooled_queue P;
+
+    for (int i = 0; i < 1000; ++i)
+        P.insert(i, (i * 7919) % 1000);
+
+    assert(P.size() == 1000);
+    assert(P.minValue() == 0);
+    assert(P.maxValue() == 999);
+
+    P.changeValue(0, -1);
+    assert(P.minValue() == -1);
+
+    for (int i = 0; i < 500; ++i)
+        P.deleteMin();
+    assert(P.size() == 500);
+
+    // Zwolnione węzły wracają do areny i są używane ponownie.
+    for (int i = 0; i < 500; ++i)
+        P.insert(i, i);
+    assert(P.size() == 1000);
+
+    // Kopia dzieli arenę z oryginałem (select_on_container_copy_construction).
+    pooled_queue Q(P);
+    assert(Q == P);
+    Q.deleteMax();
+    assert(Q.size() == 999);
+    assert(P.size() == 1000);
+
+    // merge między kolejkami o różnych arenach.
+    pooled_queue R;
+    R.insert(-5, -100);
+    P.merge(R);
+    assert(R.empty());
+    assert(P.minValue() == -100);
+
+    // swap i przypisanie przenoszące między niezależnie zbudowanymi
+    // kolejkami (różne areny): arena wędruje razem z węzłami (cechy
+    // propagate_on_container_*), więc elementy przeżywają swoją starą
+    // kolejkę.
+    {
+        pooled_queue A, B;
+        A.insert(1, 10);
+        B.insert(2, 20);
+        A.swap(B);
+        assert(A.minValue() == 20 && B.minValue() == 10);
+
+        pooled_queue C;
+        C.insert(3, 30);
+        B = std::move(C);
+        assert(B.minValue() == 30);
+    }
+
+    // changeValue nie może przypiąć areny: uchwyty węzłów trzymają kopię
+    // alokatora, a zgubiona kopia w pamięci węzła areny to cykl - arena
+    // musi umrzeć razem z kolejką.
+    std::weak_ptr<PoolArena> watch;
+    {
+        auto arena = std::make_shared<PoolArena>();
+        watch = arena;
+        pooled_queue W{PoolAllocator<void>(std::move(arena))};
+        W.insert(1, 1);
+        W.insert(2, 2);
+        for (int i = 0; i < 100; ++i)
+            W.changeValue(1, i);
+    }
+    assert(watch.expired());
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
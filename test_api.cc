@@ -0,0 +1,123 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+
+#include "priorityqueue.hh"
+
+int main() {
+    PriorityQueue<int, int> P;
+    for (int i = 0; i < 100; ++i)
+        P.insert(i, 1000 - i);
+
+    // Iteracja w porządku rosnących wartości, bez modyfikowania kolejki.
+    int count = 0;
+    int prev = -1;
+    for (auto kv : P) {
+        assert(kv.second > prev);
+        prev = kv.second;
+        assert(kv.first == 1000 - kv.second);
+        ++count;
+    }
+    assert(count == 100);
+    assert(P.size() == 100);
+
+    assert(P.begin() != P.end());
+    auto it = P.begin();
+    assert((*it).second == P.minValue());
+    ++it;
+    --it;
+    assert(it == P.begin());
+
+    // Wizytor.
+    count = 0;
+    P.for_each_ordered([&count](const int& k, const int& v) {
+        assert(k + v == 1000);
+        ++count;
+    });
+    assert(count == 100);
+
+    // erase(key) i extract(key).
+    assert(P.erase(50));
+    assert(P.size() == 99);
+    assert(!P.erase(50));
+    assert(!P.erase(12345));
+
+    auto kv50 = P.extract(51);
+    assert(kv50.first == 51 && kv50.second == 949);
+    assert(P.size() == 98);
+    try {
+        P.extract(51);
+        assert(!"extract() on missing key did not throw!");
+    } catch (const PriorityQueueNotFoundException&) {
+    }
+
+    // Przy kilku parach o tym samym kluczu znika dokładnie jedna.
+    P.insert(7, 7);
+    P.insert(7, 8);
+    size_t before = P.size();
+    assert(P.erase(7));
+    assert(P.size() == before - 1);
+
+    // Pusta kolejka: begin() == end().
+    PriorityQueue<std::string, std::string> Q;
+    assert(Q.begin() == Q.end());
+    Q.insert("k", "v");
+    auto sit = Q.begin();
+    assert((*sit).first == "k" && (*sit).second == "v");
+
+    // insert z przeniesieniem: ciężka wartość oddana przez move nie jest
+    // kopiowana - źródło zostaje wyczyszczone.
+    std::string heavy(1000, 'x');
+    std::string heavy_key = "heavy";
+    Q.insert(std::move(heavy_key), std::move(heavy));
+    assert(heavy.empty() && heavy_key.empty());
+    assert(Q.maxValue() == std::string(1000, 'x'));
+
+    // emplace konstruuje K i V wprost z argumentów.
+    Q.emplace("e", 3, 'z');
+    assert(Q.extract("e").second == "zzz");
+
+    // Odczyty po kluczu: contains/count/anyValueFor/for_each_value.
+    PriorityQueue<int, int> R;
+    R.insert(1, 10);
+    R.insert(2, 30);
+    R.insert(2, 20);
+    R.insert(2, 20);
+    assert(R.contains(2) && !R.contains(5));
+    assert(R.count(2) == 3 && R.count(1) == 1 && R.count(5) == 0);
+    assert(R.anyValueFor(2) == 20);
+    try {
+        R.anyValueFor(5);
+        assert(!"anyValueFor on missing key did not throw!");
+    } catch (const PriorityQueueNotFoundException&) {
+    }
+    int sum = 0, prev_val = -1;
+    R.for_each_value(2, [&](const int& v) {
+        assert(prev_val <= v);
+        prev_val = v;
+        sum += v;
+    });
+    assert(sum == 70);
+    R.for_each_value(5, [](const int&) { assert(!"visited missing key!"); });
+
+    // Równość po serii modyfikacji (utrzymywany hasz zawartości musi
+    // wrócić do tej samej wartości, inaczej == skłamie).
+    PriorityQueue<int, int> E1, E2;
+    E1.insert(1, 1);
+    E1.insert(2, 2);
+    E2.insert(2, 2);
+    E2.insert(1, 1);
+    assert(E1 == E2);
+    E2.insert(3, 3);
+    assert(E1 != E2);
+    E2.erase(3);
+    assert(E1 == E2);
+    E2.changeValue(2, 5);
+    assert(E1 != E2);
+    E2.changeValue(2, 2);
+    assert(E1 == E2);
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
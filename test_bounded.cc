@@ -0,0 +1,48 @@
+#include <iostream>
+#include <cassert>
+
+#include "boundedpriorityqueue.hh"
+
+int main() {
+    BoundedPriorityQueue<int, int> P(3);
+
+    assert(P.insert(1, 10));
+    assert(P.insert(2, 20));
+    assert(P.insert(3, 30));
+    assert(P.size() == 3);
+
+    // Kolejka pełna: poniżej progu odrzucamy, powyżej wypychamy minimum.
+    assert(!P.insert(4, 5));
+    assert(!P.insert(4, 10));
+    assert(P.size() == 3);
+    assert(P.insert(5, 40));
+    assert(P.size() == 3);
+    assert(P.minValue() == 20);
+    assert(P.maxValue() == 40);
+
+    // Strumień, w którym większość elementów nie wchodzi do czołówki.
+    for (int i = 0; i < 1000; ++i)
+        P.insert(i, i % 20);
+    assert(P.size() == 3);
+    assert(P.minValue() == 20);
+
+    auto top = P.popMax();
+    assert(top.second == 40 && top.first == 5);
+
+    // Pojemność zero: wszystko odrzucone.
+    BoundedPriorityQueue<int, int> Q(0);
+    assert(!Q.insert(1, 1));
+    assert(Q.empty());
+
+    // release() oddaje zwykłą kolejkę.
+    BoundedPriorityQueue<int, int> R(2);
+    R.insert(1, 1);
+    R.insert(2, 2);
+    PriorityQueue<int, int> base = R.release();
+    assert(base.size() == 2);
+    assert(R.empty());
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
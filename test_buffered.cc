@@ -0,0 +1,62 @@
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bufferedpriorityqueue.hh"
+
+int main() {
+    // Jednowątkowo: odczyt wymusza flush, więc widzi zbuforowane pary.
+    BufferedPriorityQueue<int, int> P(1000, 4);
+    P.insert(1, 10);
+    P.insert(2, 20);
+    assert(P.size() == 2);
+    assert(P.minValue() == 10 && P.maxValue() == 20);
+
+    // Przekroczenie progu pasma wsypuje paczkę samo.
+    BufferedPriorityQueue<int, int> Q(8, 1);
+    for (int i = 0; i < 20; ++i)
+        Q.insert(i, i);
+    assert(Q.flush() <= 8);  // większość zeszła progiem
+    assert(Q.size() == 20);
+
+    auto mn = Q.popMin();
+    assert(mn.first == 0 && mn.second == 0);
+    int k, v;
+    assert(Q.tryPopMin(k, v) && v == 1);
+
+    // Zryw z wielu producentów: nic nie ginie, porządek zachowany.
+    BufferedPriorityQueue<int, int> R(256);
+    const int threads = 8, per_thread = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&R, t] {
+            for (int i = 0; i < per_thread; ++i)
+                R.insert(t * per_thread + i, t * per_thread + i);
+        });
+    for (auto& w : workers) w.join();
+
+    assert(R.size() == (size_t)threads * per_thread);
+    PriorityQueue<int, int> base = R.release();
+    assert(base.size() == (size_t)threads * per_thread);
+    int prev = -1;
+    for (auto kv : base) {
+        assert(kv.second == prev + 1);
+        prev = kv.second;
+    }
+    assert(R.empty());
+
+    // Pusta kolejka: popMin rzuca, tryPopMin zwraca false.
+    BufferedPriorityQueue<int, int> S;
+    assert(!S.tryPopMin(k, v));
+    try {
+        S.popMin();
+        assert(!"popMin on empty did not throw!");
+    } catch (const PriorityQueueEmptyException&) {
+    }
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
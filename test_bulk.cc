@@ -0,0 +1,52 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+
+#include "priorityqueue.hh"
+
+int main() {
+    PriorityQueue<int, int> P;
+
+    // Wstawianie paczki do pustej kolejki.
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < 1000; ++i)
+        batch.emplace_back(i, (i * 7919) % 1000);
+    P.insert(std::move(batch));
+
+    assert(P.size() == 1000);
+    assert(P.minValue() == 0);
+    assert(P.maxValue() == 999);
+
+    // Paczka z powtórzonymi kluczami i wartościami do niepustej kolejki.
+    std::vector<std::pair<int, int>> batch2 = {
+        {5, 5}, {5, 5}, {-1, 2000}, {7, -3}};
+    P.insert(batch2.begin(), batch2.end());
+
+    assert(P.size() == 1004);
+    assert(P.minValue() == -3);
+    assert(P.minKey() == 7);
+    assert(P.maxValue() == 2000);
+    assert(P.maxKey() == -1);
+
+    // Wynik jest taki sam jak przy wstawianiu po jednej parze.
+    PriorityQueue<int, int> Q;
+    for (int i = 0; i < 1000; ++i)
+        Q.insert(i, (i * 7919) % 1000);
+    for (auto& p : batch2)
+        Q.insert(p.first, p.second);
+    while (!Q.empty() && !P.empty()) {
+        assert(Q.minValue() == P.minValue());
+        assert(Q.minKey() == P.minKey());
+        Q.deleteMin();
+        P.deleteMin();
+    }
+    assert(Q.empty() && P.empty());
+
+    // Pusta paczka jest poprawna.
+    P.insert(std::vector<std::pair<int, int>>());
+    assert(P.empty());
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <cassert>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+
+// Kolejka z odwróconym porządkiem wartości: minValue() to największa
+// liczba, bez opakowywania V w typ pośredniczący z własnym operator<.
+using reversed_queue =
+    PriorityQueue<int, int, std::allocator<void>, DefaultQueueFeatures,
+                  pq_detail::raw_less, std::greater<int>>;
+
+// Porządek rzucający po odpaleniu lontu: fuse = n odpala n-te porównanie,
+// fuse = 0 nigdy nie rzuca.
+struct FragileCompare {
+    static int fuse;
+    bool operator()(const int& lhs, const int& rhs) const {
+        if (FragileCompare::fuse > 0 && --FragileCompare::fuse == 0)
+            throw std::runtime_error("FragileCompare");
+        return lhs < rhs;
+    }
+};
+int FragileCompare::fuse = 0;
+
+// Porządek ze stanem: moduł m rozstrzyga o kolejności.
+struct ModCompare {
+    int m;
+    bool operator()(const int& lhs, const int& rhs) const {
+        return lhs % m < rhs % m;
+    }
+};
+
+int main() {
+    reversed_queue P;
+    P.insert(1, 10);
+    P.insert(2, 30);
+    P.insert(3, 20);
+    assert(P.minValue() == 30 && P.minKey() == 2);
+    assert(P.maxValue() == 10 && P.maxKey() == 1);
+
+    auto mn = P.popMin();
+    assert(mn.second == 30);
+    P.changeValue(3, 40);
+    assert(P.minValue() == 40);
+
+    // Iteracja idzie w porządku komparatora (tu: malejące wartości).
+    std::vector<std::pair<int, int>> batch = {{4, 5}, {5, 25}};
+    P.insert(std::move(batch));
+    int prev = 1000;
+    for (auto kv : P) {
+        assert(kv.second < prev);
+        prev = kv.second;
+    }
+
+    // Zapytania zakresowe honorują porządek: [lo, hi) po odwróconej osi.
+    assert(P.countValueRange(40, 5) == 3);
+    assert(P.countValueRange(5, 40) == 0);
+
+    // Komparator ze stanem podany konstruktorem.
+    PriorityQueue<int, int, std::allocator<void>, DefaultQueueFeatures,
+                  pq_detail::raw_less, ModCompare>
+        M(pq_detail::raw_less(), ModCompare{10});
+    M.insert(1, 7);
+    M.insert(2, 23);
+    M.insert(3, 15);
+    assert(M.minValue() == 23);  // 23 % 10 == 3 - najmniejsze
+    assert(M.maxValue() == 7);
+
+    // Kopia i swap zachowują porządek.
+    auto C = M;
+    assert(C.minValue() == 23);
+    reversed_queue Q;
+    Q.insert(9, 9);
+    P.swap(Q);
+    assert(P.minValue() == 9);
+
+    // Rzucający komparator wartości: kolejka musi zejść ze ścieżki bez
+    // wycofywania (bramka nothrow_fast_path pyta o skonfigurowany
+    // porządek, nie o goły operator<). Lont odpala n-te porównanie,
+    // więc wyjątek trafia też w środek operacji.
+    PriorityQueue<int, int, std::allocator<void>, DefaultQueueFeatures,
+                  pq_detail::raw_less, FragileCompare>
+        F;
+    F.insert(1, 10);
+    F.insert(2, 20);
+    F.insert(3, 30);
+    auto snapshot = F;
+
+    for (int fuse = 1;; ++fuse) {
+        FragileCompare::fuse = fuse;
+        try {
+            F.changeValue(2, 5);
+            break;
+        } catch (const std::runtime_error&) {
+            // Silna gwarancja: po wyjątku nic się nie zmieniło.
+            FragileCompare::fuse = 0;
+            assert(F == snapshot);
+        }
+    }
+    FragileCompare::fuse = 0;
+    assert(F.minValue() == 5 && F.minKey() == 2);
+    assert(F.size() == 3);
+
+    for (int fuse = 1;; ++fuse) {
+        FragileCompare::fuse = fuse;
+        try {
+            F.insert(4, 40);
+            break;
+        } catch (const std::runtime_error&) {
+            FragileCompare::fuse = 0;
+            assert(F.size() == 3);
+        }
+    }
+    FragileCompare::fuse = 0;
+    assert(F.size() == 4 && F.maxValue() == 40);
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
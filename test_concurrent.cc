@@ -0,0 +1,89 @@
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include "concurrentpriorityqueue.hh"
+
+int main() {
+    const int num_threads = 8;
+    const int per_thread = 5000;
+
+    ConcurrentPriorityQueue<int, int> P;
+
+    // Równolegli producenci.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&P, t]() {
+            for (int i = 0; i < per_thread; ++i)
+                P.insert(t * per_thread + i, i);
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    assert(P.size() == size_t(num_threads) * per_thread);
+    assert(P.minValue() == 0);
+
+    // Równoległi konsumenci zdejmują wszystko; wartości per wątek rosną.
+    std::vector<std::thread> consumers;
+    std::vector<size_t> popped(num_threads, 0);
+    for (int t = 0; t < num_threads; ++t) {
+        consumers.emplace_back([&P, &popped, t]() {
+            int k, v;
+            int last = -1;
+            while (P.tryPopMin(k, v)) {
+                assert(v >= last);
+                last = v;
+                ++popped[t];
+            }
+        });
+    }
+    for (auto& th : consumers)
+        th.join();
+
+    size_t total = 0;
+    for (size_t c : popped)
+        total += c;
+    assert(total == size_t(num_threads) * per_thread);
+    assert(P.empty());
+
+    // changeValue i merge.
+    ConcurrentPriorityQueue<int, int> Q(4), R(3);
+    Q.insert(1, 10);
+    Q.insert(2, 20);
+    R.insert(3, 5);
+    Q.changeValue(2, 2);
+    Q.merge(R);
+    assert(R.empty());
+    assert(Q.size() == 3);
+    auto mn = Q.popMin();
+    assert(mn.first == 2 && mn.second == 2);
+    mn = Q.popMin();
+    assert(mn.first == 3 && mn.second == 5);
+
+    // swap wymienia zawartość shardów (nie wektory shardów), także przy
+    // różnych liczbach shardów - elementy wracają rozrzucone po haszu
+    // strony, na której wylądowały.
+    ConcurrentPriorityQueue<int, int> S1(4), S2(7);
+    for (int i = 0; i < 100; ++i)
+        S1.insert(i, i);
+    S2.insert(1000, 1000);
+    S1.swap(S2);
+    assert(S1.size() == 1 && S2.size() == 100);
+    auto sm = S1.popMin();
+    assert(sm.first == 1000 && sm.second == 1000);
+    sm = S2.popMin();
+    assert(sm.first == 0 && sm.second == 0);
+
+    // Równe liczby shardów: wymiana parami pod zamkami.
+    ConcurrentPriorityQueue<int, int> S3(4), S4(4);
+    S3.insert(1, 1);
+    S4.insert(2, 2);
+    S3.swap(S4);
+    assert(S3.popMin().second == 2 && S4.popMin().second == 1);
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "cowpriorityqueue.hh"
+
+int main() {
+    CowPriorityQueue<std::string, std::string> P;
+    P.insert("a", "1");
+    P.insert("b", "2");
+    P.insert("c", "3");
+
+    // Klon jest tani i współdzieli stan.
+    CowPriorityQueue<std::string, std::string> snapshot = P;
+    assert(P.shared() && snapshot.shared());
+    assert(snapshot.size() == 3);
+    assert(snapshot.minValue() == "1" && snapshot.maxValue() == "3");
+
+    // Mutacja pisarza nie zmienia migawki.
+    P.insert("d", "4");
+    P.deleteMin();
+    assert(!P.shared() && !snapshot.shared());
+    assert(P.size() == 3 && snapshot.size() == 3);
+    assert(snapshot.minValue() == "1");
+    assert(P.minValue() == "2");
+
+    // Mutacja migawki też nie dotyka pisarza.
+    CowPriorityQueue<std::string, std::string> other = snapshot;
+    other.changeValue("a", "9");
+    assert(other.maxValue() == "9");
+    assert(snapshot.minValue() == "1");
+
+    // Iteracja po migawce w porządku wartości.
+    int count = 0;
+    for (auto kv : snapshot) {
+        (void)kv;
+        ++count;
+    }
+    assert(count == 3);
+
+    // popMin/erase/extract odłączają jak każda mutacja.
+    CowPriorityQueue<std::string, std::string> q2 = P;
+    auto mn = q2.popMin();
+    assert(mn.second == "2");
+    assert(P.size() == 3 && q2.size() == 2);
+    assert(q2.erase("c"));
+    auto kv = q2.extract("d");
+    assert(kv.second == "4");
+    assert(q2.empty() && P.size() == 3);
+
+    // merge odłącza obie strony.
+    CowPriorityQueue<std::string, std::string> A, B;
+    A.insert("x", "1");
+    B.insert("y", "2");
+    CowPriorityQueue<std::string, std::string> Bsnap = B;
+    A.merge(B);
+    assert(A.size() == 2 && B.empty());
+    assert(Bsnap.size() == 1);
+
+    // Przeniesienie zostawia źródło puste, bez kopii.
+    CowPriorityQueue<std::string, std::string> moved = std::move(A);
+    assert(moved.size() == 2 && A.empty());
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
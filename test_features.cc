@@ -0,0 +1,102 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+
+// Kolejka bez internowania wartości - boksowane V, ale bez all_values.
+using nodedup_queue =
+    PriorityQueue<std::string, std::string, std::allocator<void>, NoValueDedup>;
+
+// Kolejka z licznikami operacji.
+using stats_queue =
+    PriorityQueue<std::string, std::string, std::allocator<void>, WithStats>;
+
+static void test_stats() {
+    stats_queue S;
+    S.insert("a", "1");
+    S.insert("b", "1");  // wartość internowana - reuse zamiast alokacji
+    S.insert("b", "2");
+    assert(S.stats().inserts == 3);
+    assert(S.stats().value_intern_hits == 1);
+    assert(S.stats().box_allocs == 4);  // klucze "a", "b" + wartości "1", "2"
+
+    assert(S.distinctKeys() == 2);
+    assert(S.averageKeyFanout() == 1.5);
+
+    S.changeValue("a", "5");
+    assert(S.stats().change_values == 1);
+
+    S.deleteMin();
+    S.popMax();
+    assert(S.stats().deletes == 2);
+
+    stats_queue T;
+    T.insert("c", "3");
+    S.merge(T);
+    T.insert("d", "4");
+    S.mergeFast(std::move(T));
+    assert(S.stats().merges == 2);
+
+    S.resetStats();
+    assert(S.stats().inserts == 0 && S.stats().deletes == 0);
+    assert(S.size() == 3);  // liczniki to nie zawartość
+
+    // Liczniki wędrują razem z zawartością przy swap.
+    stats_queue U;
+    U.insert("e", "6");
+    S.swap(U);
+    assert(S.stats().inserts == 1 && U.stats().inserts == 0);
+}
+
+int main() {
+    nodedup_queue P;
+    P.insert("a", "1");
+    P.insert("b", "2");
+    P.insert("b", "2");
+    P.insert("c", "0");
+
+    assert(P.size() == 4);
+    assert(P.minKey() == "c" && P.minValue() == "0");
+    assert(P.maxKey() == "b" && P.maxValue() == "2");
+
+    P.changeValue("c", "9");
+    assert(P.maxKey() == "c" && P.maxValue() == "9");
+    assert(P.minKey() == "a" && P.minValue() == "1");
+
+    try {
+        P.changeValue("x", "0");
+        assert(!"changeValue on missing key did not throw!");
+    } catch (const PriorityQueueNotFoundException&) {
+    }
+
+    auto mn = P.popMin();
+    assert(mn.first == "a" && mn.second == "1");
+
+    nodedup_queue Q;
+    Q.insert("d", "5");
+    P.merge(Q);
+    assert(Q.empty() && P.size() == 4);
+
+    nodedup_queue R;
+    R.insert("e", "7");
+    P.mergeFast(std::move(R));
+    assert(R.empty() && P.size() == 5);
+
+    std::vector<std::pair<std::string, std::string>> batch = {
+        {"f", "3"}, {"g", "3"}};
+    P.insert(std::move(batch));
+    assert(P.size() == 7);
+
+    while (!P.empty())
+        P.deleteMin();
+    assert(P.empty());
+
+    test_stats();
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+
+// Kolejka z płaskimi indeksami po wartości; int/int dodatkowo przechodzi
+// przez inline'owe boxy, string/string przez boxy z internowaniem.
+using flat_int_queue =
+    PriorityQueue<int, int, std::allocator<void>, FlatValueIndex>;
+using flat_str_queue =
+    PriorityQueue<std::string, std::string, std::allocator<void>,
+                  FlatValueIndex>;
+
+int main() {
+    flat_int_queue P;
+    for (int i = 99; i >= 0; --i)
+        P.insert(i, 2 * i);
+    assert(P.size() == 100);
+    assert(P.minValue() == 0 && P.maxValue() == 198);
+    assert(P.minKey() == 0 && P.maxKey() == 99);
+
+    // deleteMin to leniwe przesunięcie przedrostka - dużo zdejmowania z
+    // przodu nie może psuć reszty indeksu.
+    for (int i = 0; i < 60; ++i)
+        P.deleteMin();
+    assert(P.size() == 40);
+    assert(P.minValue() == 120);
+    int prev = -1;
+    for (auto kv : P) {
+        assert(prev < kv.second);
+        prev = kv.second;
+    }
+
+    // Wstawienie w środek po skompaktowaniu przedrostka.
+    P.insert(1000, 121);
+    assert(P.size() == 41);
+    P.changeValue(1000, 300);
+    assert(P.maxValue() == 300);
+    assert(P.erase(1000));
+
+    auto mx = P.popMax();
+    assert(mx.second == 198);
+    auto kv70 = P.extract(70);
+    assert(kv70.second == 140);
+
+    // Paczka: hintowany przebieg trafia w push_back.
+    flat_int_queue B;
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < 50; ++i)
+        batch.emplace_back(i, i);
+    B.insert(std::move(batch));
+    assert(B.size() == 50 && B.maxValue() == 49);
+
+    // merge i mergeFast na płaskim backendzie.
+    flat_int_queue C;
+    C.insert(500, -1);
+    B.merge(C);
+    assert(C.empty() && B.minValue() == -1);
+    flat_int_queue D;
+    D.insert(501, 1000);
+    B.mergeFast(std::move(D));
+    assert(D.empty() && B.maxValue() == 1000);
+
+    // Porównania kolejek.
+    flat_int_queue E, F;
+    E.insert(1, 1);
+    F.insert(1, 1);
+    assert(E == F);
+    F.insert(2, 2);
+    assert(E != F && E < F);
+
+    // Boksowane typy: internowanie w płaskim all_values.
+    flat_str_queue S;
+    S.insert("a", "dluga wspolna wartosc dluga wspolna wartosc");
+    S.insert("b", "dluga wspolna wartosc dluga wspolna wartosc");
+    S.insert("c", "inna");
+    assert(S.size() == 3);
+    S.changeValue("c", "zzz");
+    assert(S.maxKey() == "c" && S.maxValue() == "zzz");
+    auto mn = S.popMin();
+    assert(mn.second == "dluga wspolna wartosc dluga wspolna wartosc");
+    while (!S.empty())
+        S.deleteMax();
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <cassert>
+
+#include "priorityqueue.hh"
+
+int main() {
+    PriorityQueue<int, int> P;
+
+    auto h1 = P.insert(1, 100);
+    auto h2 = P.insert(2, 200);
+    P.insert(3, 300);
+
+    // Aktualizacja przez uchwyt zamiast wyszukiwania klucza.
+    P.changeValue(h2, 1);
+    assert(P.minKey() == 2 && P.minValue() == 1);
+
+    // Wielokrotny decrease-key przez ten sam uchwyt.
+    for (int i = 0; i < 100; ++i)
+        P.changeValue(h1, 50 - i);
+    assert(P.minKey() == 1 && P.minValue() == -49);
+
+    // Uchwyt pozostaje ważny po operacjach na innych kluczach.
+    P.deleteMax();
+    P.insert(4, 400);
+    P.changeValue(h1, 1000);
+    assert(P.maxKey() == 1 && P.maxValue() == 1000);
+
+    // Uchwyt wskazuje klucz, nie konkretną parę.
+    PriorityQueue<int, int> Q;
+    auto g = Q.insert(7, 10);
+    Q.insert(7, 20);
+    Q.changeValue(g, 15);
+    assert(Q.size() == 2);
+    assert(Q.minKey() == 7 && Q.maxKey() == 7);
+
+    // Relokacja przy zduplikowanych wartościach i zmianie na tę samą
+    // wartość: wszystkie indeksy zostają spójne.
+    PriorityQueue<int, int> R;
+    R.insert(1, 5);
+    R.insert(2, 5);
+    R.insert(3, 5);
+    R.changeValue(2, 5);
+    assert(R.size() == 3 && R.minValue() == 5 && R.maxValue() == 5);
+    R.changeValue(2, 1);
+    assert(R.minKey() == 2 && R.minValue() == 1);
+    assert(R.erase(2) && R.erase(1) && R.erase(3) && R.empty());
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+#include "poolallocator.hh"
+
+int main() {
+    // Szacunek rośnie z zawartością i wraca po opróżnieniu.
+    PriorityQueue<int, int> P;
+    auto empty_bytes = P.memoryUsage();
+    assert(empty_bytes >= sizeof(P));
+    for (int i = 0; i < 1000; ++i)
+        P.insert(i, i);
+    auto full_bytes = P.memoryUsage();
+    assert(full_bytes > empty_bytes + 1000 * sizeof(void*));
+
+    // compact() nie zmienia zawartości ani wyniku porównań.
+    auto C = P;
+    P.compact();
+    assert(P == C && P.size() == 1000);
+    assert(P.minValue() == 0 && P.maxValue() == 999);
+    P.popMin();
+    C.popMin();
+    assert(P == C);
+
+    // Po purge szacunek spada dopiero po przebudowie (liczymy węzły,
+    // nie wolne listy alokatora - ale boxy i węzły znikają z rachunku).
+    PriorityQueue<std::string, std::string> Q;
+    for (int i = 0; i < 500; ++i)
+        Q.insert("klucz" + std::to_string(i), "wartosc" + std::to_string(i));
+    auto before = Q.memoryUsage();
+    Q.eraseValuesBelow("wartosc9");
+    Q.compact();
+    assert(Q.memoryUsage() < before / 2);
+    assert(Q.size() == 11);  // wartosc9 i wartosc9[0-9]
+    assert(Q.minValue() == "wartosc9");
+
+    // Wariant płaski: compact() zrzuca też leniwy prefiks i luz wektora.
+    PriorityQueue<int, int, std::allocator<void>, FlatValueIndex> F;
+    for (int i = 0; i < 1000; ++i)
+        F.insert(i, i);
+    for (int i = 0; i < 900; ++i)
+        F.deleteMin();
+    auto flat_before = F.memoryUsage();
+    F.compact();
+    assert(F.memoryUsage() < flat_before);
+    assert(F.size() == 100 && F.minValue() == 900);
+
+    // Tryb min_only: jeden indeks, ale rachunek i przebudowa działają.
+    PriorityQueue<int, int, std::allocator<void>, MinOnly> M;
+    M.insert(1, 1);
+    M.insert(2, 2);
+    assert(M.memoryUsage() > sizeof(M));
+    M.compact();
+    assert(M.size() == 2 && M.popMin().second == 1);
+
+    // Arena PoolAllocatora: po przebudowie węzły muszą żyć w arenie
+    // kolejki, nie w tymczasowej arenie z wnętrza compact().
+    PriorityQueue<int, int, PoolAllocator<void>> A;
+    for (int i = 0; i < 2000; ++i)
+        A.insert(i, i);
+    for (int i = 0; i < 1500; ++i)
+        A.deleteMin();
+    A.compact();
+    assert(A.size() == 500);
+    int expected = 1500;
+    for (auto kv : A)
+        assert(kv.second == expected++);
+    assert(A.minValue() == 1500 && A.maxValue() == 1999);
+
+    // Pusta kolejka: compact() jest bezpieczne.
+    PriorityQueue<int, int> E;
+    E.compact();
+    assert(E.empty());
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <cassert>
+#include <utility>
+
+#include "priorityqueue.hh"
+
+int main() {
+    // mergeFast do pustej i z pustej kolejki.
+    PriorityQueue<int, int> P;
+    PriorityQueue<int, int> Q;
+    Q.insert(1, 10);
+    Q.insert(2, 20);
+    P.mergeFast(std::move(Q));
+    assert(Q.empty());
+    assert(P.size() == 2);
+    P.mergeFast(std::move(Q));
+    assert(P.size() == 2);
+
+    // Scalanie z powtórzonymi kluczami i wartościami po obu stronach.
+    PriorityQueue<int, int> R;
+    R.insert(1, 10);
+    R.insert(1, 15);
+    R.insert(3, 20);
+    P.mergeFast(std::move(R));
+    assert(R.empty());
+    assert(P.size() == 5);
+    assert(P.minKey() == 1 && P.minValue() == 10);
+    assert(P.maxKey() == 3 && P.maxValue() == 20);
+
+    // Wynik jest równoważny zwykłemu merge().
+    PriorityQueue<int, int> A, B, C, D;
+    for (int i = 0; i < 100; ++i) {
+        A.insert(i % 7, i);
+        B.insert(i % 7, i);
+        C.insert(i % 5, 200 - i);
+        D.insert(i % 5, 200 - i);
+    }
+    A.merge(C);
+    B.mergeFast(std::move(D));
+    assert(A.size() == B.size());
+    while (!A.empty()) {
+        assert(A.minKey() == B.minKey());
+        assert(A.minValue() == B.minValue());
+        A.deleteMin();
+        B.deleteMin();
+    }
+
+    // changeValue i deleteMin działają na scalonej kolejce.
+    PriorityQueue<int, int> S, T;
+    S.insert(1, 100);
+    T.insert(1, 50);
+    T.insert(2, 200);
+    S.mergeFast(std::move(T));
+    S.changeValue(2, -1);
+    assert(S.minKey() == 2 && S.minValue() == -1);
+    S.deleteMin();
+    S.deleteMin();
+    S.deleteMin();
+    assert(S.empty());
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+#include "parallelmerge.hh"
+
+int main() {
+    // mergeAll: k-way scalanie bez kopiowania akumulatora.
+    PriorityQueue<int, int> P;
+    P.insert(0, 0);
+
+    std::vector<PriorityQueue<int, int>> shards(4);
+    for (int s = 0; s < 4; ++s)
+        for (int i = 0; i < 100; ++i)
+            shards[s].insert(1000 * s + i, 4 * i + s + 1);
+
+    P.mergeAll(std::move(shards));
+    assert(P.size() == 401);
+    assert(P.minValue() == 0);
+    assert(P.maxValue() == 400);
+    int prev = -1;
+    for (auto kv : P) {
+        assert(prev < kv.second);
+        prev = kv.second;
+    }
+
+    // Pusta lista źródeł i puste źródła nie przeszkadzają.
+    PriorityQueue<int, int> Q;
+    Q.mergeAll({});
+    assert(Q.empty());
+    std::vector<PriorityQueue<int, int>> empties(3);
+    Q.mergeAll(std::move(empties));
+    assert(Q.empty());
+
+    // mergeAllParallel: ten sam wynik co scalanie sekwencyjne.
+    std::vector<PriorityQueue<int, int>> shards2(16);
+    for (int s = 0; s < 16; ++s)
+        for (int i = 0; i < 50; ++i)
+            shards2[s].insert(1000 * s + i, 16 * i + s);
+
+    PriorityQueue<int, int> R = mergeAllParallel(std::move(shards2), 4);
+    assert(R.size() == 16 * 50);
+    prev = -1;
+    for (auto kv : R) {
+        assert(prev < kv.second);
+        prev = kv.second;
+    }
+    assert(R.minValue() == 0 && R.maxValue() == 16 * 50 - 1);
+
+    // Jedna kolejka i zero wątków to przypadki brzegowe, nie błędy.
+    std::vector<PriorityQueue<int, int>> one(1);
+    one[0].insert(7, 7);
+    PriorityQueue<int, int> S = mergeAllParallel(std::move(one), 0);
+    assert(S.size() == 1 && S.minKey() == 7);
+
+    assert(mergeAllParallel(std::vector<PriorityQueue<int, int>>()).empty());
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
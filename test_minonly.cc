@@ -0,0 +1,91 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+
+// Kolejka czysto minimowa: samo sorted_by_value, bez indeksu kluczy
+// i internowania wartości.
+template <typename K, typename V>
+using min_queue = PriorityQueue<K, V, std::allocator<void>, MinOnly>;
+
+// Polityki można składać dziedziczeniem, jak w test_features.cc.
+struct WithMinOnlyStats : MinOnly {
+    static constexpr bool collect_stats = true;
+};
+
+int main() {
+    min_queue<int, int> P;
+    P.insert(3, 30);
+    P.insert(1, 10);
+    P.insert(2, 20);
+    assert(P.size() == 3 && !P.empty());
+    assert(P.minValue() == 10 && P.minKey() == 1);
+    // Strona max żyje w tym samym indeksie wartości, więc działa nadal;
+    // odrzucane jest tylko API oparte o indeks kluczy.
+    assert(P.maxValue() == 30 && P.maxKey() == 3);
+
+    auto mn = P.popMin();
+    assert(mn.first == 1 && mn.second == 10);
+    P.deleteMin();
+    assert(P.size() == 1);
+    int k, v;
+    assert(P.tryPopMin(k, v) && k == 3 && v == 30);
+    assert(!P.tryPopMin(k, v));
+
+    // Wsad, iteracja i zapytania zakresowe po wartości nie potrzebują
+    // indeksu kluczy.
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 9; i >= 0; --i)
+        batch.emplace_back(i, i);
+    P.insert(std::move(batch));
+    assert(P.size() == 10);
+    int prev = -1;
+    for (auto kv : P) {
+        assert(kv.second > prev);
+        prev = kv.second;
+    }
+    assert(P.countValueRange(2, 5) == 3);
+    assert(P.eraseValuesBelow(4) == 4);
+    auto out = P.extractValueRange(4, 7);
+    assert(out.size() == 3 && out.front().second == 4);
+
+    // merge/mergeFast/mergeAll pomijają nieistniejące indeksy.
+    min_queue<int, int> Q, R;
+    Q.insert(100, 100);
+    R.insert(200, 200);
+    P.merge(Q);
+    assert(Q.empty());
+    P.mergeFast(std::move(R));
+    assert(P.size() == 5 && R.empty());
+
+    // Kopia, przypisanie, swap i równość jak w pełnej kolejce.
+    auto C = P;
+    assert(C == P);
+    C.popMin();
+    assert(C != P);
+    C.swap(P);
+    assert(C.size() == 5);
+
+    // Klucze i wartości z alokacją (ścieżka z wycofywaniem).
+    min_queue<std::string, std::string> S;
+    S.insert("b", "bb");
+    S.insert("a", "aa");
+    assert(S.minValue() == "aa" && S.popMin().first == "a");
+
+    // Liczniki: dwie alokacje boxów na insert, bez trafień internowania.
+    PriorityQueue<std::string, std::string, std::allocator<void>,
+                  WithMinOnlyStats>
+        T;
+    T.insert("x", "v");
+    T.insert("y", "v");
+    assert(T.stats().inserts == 2);
+    assert(T.stats().box_allocs == 4);
+    assert(T.stats().value_intern_hits == 0);
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+
+#include "priorityqueue.hh"
+
+int main() {
+    PriorityQueue<int, int> P;
+    P.insert(1, 42);
+    P.insert(2, 13);
+    P.insert(3, 13);
+
+    auto mn = P.popMin();
+    assert(mn.first == 2 && mn.second == 13);
+    auto mx = P.popMax();
+    assert(mx.first == 1 && mx.second == 42);
+    assert(P.size() == 1);
+
+    int k, v;
+    assert(P.tryPopMin(k, v));
+    assert(k == 3 && v == 13);
+    assert(P.empty());
+    assert(!P.tryPopMin(k, v));
+
+    try {
+        P.popMin();
+        assert(!"popMin() on empty queue did not throw!");
+    } catch (const PriorityQueueEmptyException&) {
+    }
+    try {
+        P.popMax();
+        assert(!"popMax() on empty queue did not throw!");
+    } catch (const PriorityQueueEmptyException&) {
+    }
+
+    // Typ z alokacją - ścieżka przenosząca.
+    PriorityQueue<std::string, std::string> Q;
+    Q.insert("a", "small");
+    Q.insert("b", "big");
+    auto p = Q.popMax();
+    assert(p.first == "a" && p.second == "small");
+    p = Q.popMin();
+    assert(p.first == "b" && p.second == "big");
+    assert(Q.empty());
+
+    // Współdzielone klucze i wartości nie psują pozostałych elementów.
+    PriorityQueue<std::string, std::string> R;
+    R.insert("x", "v1");
+    R.insert("x", "v2");
+    R.insert("y", "v1");
+    auto q = R.popMin();
+    assert(q.first == "x" && q.second == "v1");
+    assert(R.minKey() == "y" && R.minValue() == "v1");
+    assert(R.maxKey() == "x" && R.maxValue() == "v2");
+
+    // Zdejmowanie paczkami: popMinN rosnąco, popMaxN malejąco.
+    PriorityQueue<int, int> S;
+    for (int i = 0; i < 10; ++i)
+        S.insert(i, i);
+    auto lo = S.popMinN(3);
+    assert(lo.size() == 3);
+    assert(lo[0].second == 0 && lo[1].second == 1 && lo[2].second == 2);
+    auto hi = S.popMaxN(3);
+    assert(hi.size() == 3);
+    assert(hi[0].second == 9 && hi[1].second == 8 && hi[2].second == 7);
+    assert(S.size() == 4 && S.minValue() == 3 && S.maxValue() == 6);
+
+    // k większe od rozmiaru opróżnia kolejkę; k == 0 nic nie robi.
+    assert(S.popMinN(100).size() == 4);
+    assert(S.empty());
+    assert(S.popMinN(5).empty() && S.popMaxN(0).empty());
+
+    // Ciężkie typy: zawartość wraca przeniesieniem, duplikaty wartości
+    // i kluczy nie psują pozostałych par.
+    PriorityQueue<std::string, std::string> T;
+    T.insert("a", "v1");
+    T.insert("b", "v1");
+    T.insert("c", "v2");
+    T.insert("c", "v3");
+    auto batch = T.popMinN(2);
+    assert(batch[0].second == "v1" && batch[1].second == "v1");
+    assert(T.size() == 2 && T.minKey() == "c" && T.minValue() == "v2");
+    auto rest = T.popMaxN(2);
+    assert(rest[0].second == "v3" && rest[1].second == "v2");
+    assert(T.empty());
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "priorityqueue.hh"
+
+int main() {
+    PriorityQueue<int, int> P;
+    for (int i = 0; i < 100; ++i)
+        P.insert(i, i);
+
+    assert(P.countValueRange(10, 20) == 10);
+    assert(P.countValueRange(0, 100) == 100);
+    assert(P.countValueRange(50, 50) == 0);
+    assert(P.countValueRange(60, 40) == 0);
+    assert(P.countValueRange(-10, 5) == 5);
+    assert(P.countValueRange(95, 1000) == 5);
+
+    // Przebieg wygaszania: jedno cięcie zamiast pętli deleteMin().
+    assert(P.eraseValuesBelow(30) == 30);
+    assert(P.size() == 70);
+    assert(P.minValue() == 30);
+    assert(P.eraseValuesBelow(30) == 0);
+    assert(P.eraseValuesBelow(-5) == 0);
+
+    auto mid = P.extractValueRange(40, 50);
+    assert(mid.size() == 10);
+    for (size_t i = 0; i < mid.size(); ++i) {
+        assert(mid[i].second == 40 + (int)i);
+        assert(mid[i].first == mid[i].second);
+    }
+    assert(P.size() == 60);
+    assert(P.countValueRange(40, 50) == 0);
+
+    // Indeks kluczowy jest spójny po cięciu: usunięte klucze znikły.
+    assert(!P.erase(45));
+    assert(P.erase(55));
+    P.changeValue(60, -1);
+    assert(P.minValue() == -1);
+
+    // Duplikaty wartości i współdzielone klucze w obrębie spanu.
+    PriorityQueue<int, int> Q;
+    for (int i = 0; i < 10; ++i) {
+        Q.insert(1, 5);
+        Q.insert(2, 5);
+    }
+    Q.insert(3, 10);
+    assert(Q.countValueRange(5, 6) == 20);
+    assert(Q.eraseValuesBelow(6) == 20);
+    assert(Q.size() == 1 && Q.minKey() == 3);
+
+    // Wycięcie wszystkiego zostawia kolejkę pustą, ale zdatną do użycia.
+    auto rest = Q.extractValueRange(0, 1000);
+    assert(rest.size() == 1 && rest[0].first == 3);
+    assert(Q.empty());
+    Q.insert(7, 7);
+    assert(Q.size() == 1);
+
+    // Te same operacje na płaskim backendzie (cięcie prefiksu to tylko
+    // przesunięcie head).
+    PriorityQueue<int, int, std::allocator<void>, FlatValueIndex> F;
+    for (int i = 0; i < 50; ++i)
+        F.insert(i, i);
+    assert(F.countValueRange(10, 20) == 10);
+    assert(F.eraseValuesBelow(25) == 25);
+    assert(F.minValue() == 25);
+    auto fr = F.extractValueRange(30, 35);
+    assert(fr.size() == 5 && F.size() == 20);
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
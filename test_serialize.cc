@@ -0,0 +1,135 @@
+#include <iostream>
+#include <cassert>
+#include <functional>
+#include <sstream>
+#include <string>
+
+#include "priorityqueue.hh"
+
+struct Score {
+    double score;
+    int shard;
+
+    bool operator<(const Score& rhs) const { return score < rhs.score; }
+};
+
+int main() {
+    PriorityQueue<int, int> P;
+    for (int i = 0; i < 1000; ++i)
+        P.insert(i, (i * 7919) % 500);
+
+    std::stringstream buf;
+    P.serialize(buf);
+
+    PriorityQueue<int, int> Q;
+    Q.insert(-1, -1);  // zawartość ma zostać zastąpiona
+    Q.deserialize(buf);
+
+    assert(Q.size() == P.size());
+    while (!P.empty()) {
+        assert(P.minKey() == Q.minKey());
+        assert(P.minValue() == Q.minValue());
+        P.deleteMin();
+        Q.deleteMin();
+    }
+    assert(Q.empty());
+
+    // Pusta kolejka też się serializuje.
+    std::stringstream buf2;
+    P.serialize(buf2);
+    Q.insert(5, 5);
+    Q.deserialize(buf2);
+    assert(Q.empty());
+
+    // Trywialnie kopiowalna struktura jako wartość.
+    PriorityQueue<int, Score> R;
+    R.insert(1, Score{2.5, 7});
+    R.insert(2, Score{-1.0, 3});
+    std::stringstream buf3;
+    R.serialize(buf3);
+    PriorityQueue<int, Score> S;
+    S.deserialize(buf3);
+    assert(S.size() == 2);
+    assert(S.minKey() == 2 && S.minValue().shard == 3);
+    assert(S.maxKey() == 1 && S.maxValue().shard == 7);
+
+    // Ucięta albo przekłamana migawka: wyjątek i nietknięta kolejka.
+    std::stringstream buf4;
+    P.insert(1, 1);
+    P.insert(2, 2);
+    P.serialize(buf4);
+    std::string bytes = buf4.str();
+
+    PriorityQueue<int, int> T;
+    T.insert(9, 9);
+    auto snapshot = T;
+
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 3));
+    try {
+        T.deserialize(truncated);
+        assert(!"deserialize() of truncated snapshot did not throw!");
+    } catch (const PriorityQueueSnapshotException&) {
+    }
+    assert(T == snapshot);
+
+    std::stringstream empty_stream;
+    try {
+        T.deserialize(empty_stream);
+        assert(!"deserialize() of empty stream did not throw!");
+    } catch (const PriorityQueueSnapshotException&) {
+    }
+    assert(T == snapshot);
+
+    // Zawyżony licznik w nagłówku kończy się wyjątkiem przy pierwszej
+    // brakującej parze, bez alokowania count elementów z góry.
+    std::string forged = bytes;
+    forged[0] = '\xff';
+    forged[4] = '\x7f';
+    std::stringstream lying(forged);
+    try {
+        T.deserialize(lying);
+        assert(!"deserialize() with forged count did not throw!");
+    } catch (const PriorityQueueSnapshotException&) {
+    }
+    assert(T == snapshot);
+
+    // Porządek spoza domyślnego przeżywa round-trip: kolejka odtwarza się
+    // pod swoim komparatorem, nie pod domyślnym operator<.
+    using reversed_queue =
+        PriorityQueue<int, int, std::allocator<void>, DefaultQueueFeatures,
+                      pq_detail::raw_less, std::greater<int>>;
+    reversed_queue G;
+    G.insert(1, 10);
+    G.insert(2, 30);
+    G.insert(3, 20);
+    std::stringstream buf5;
+    G.serialize(buf5);
+    reversed_queue H;
+    H.deserialize(buf5);
+    assert(H.size() == 3);
+    assert(H.minValue() == 30 && H.minKey() == 2);
+    assert(H.maxValue() == 10 && H.maxKey() == 1);
+
+    // Komparator ze stanem: stan celu (modulo) rządzi odtworzonym porządkiem.
+    struct ModCompare {
+        int m;
+        bool operator()(const int& lhs, const int& rhs) const {
+            return lhs % m < rhs % m;
+        }
+    };
+    PriorityQueue<int, int, std::allocator<void>, DefaultQueueFeatures,
+                  pq_detail::raw_less, ModCompare>
+        M1(pq_detail::raw_less(), ModCompare{10});
+    M1.insert(1, 7);
+    M1.insert(2, 23);
+    M1.insert(3, 15);
+    std::stringstream buf6;
+    M1.serialize(buf6);
+    decltype(M1) M2(pq_detail::raw_less(), ModCompare{10});
+    M2.deserialize(buf6);
+    assert(M2.minValue() == 23 && M2.maxValue() == 7);
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
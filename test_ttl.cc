@@ -0,0 +1,60 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+
+#include "ttlpriorityqueue.hh"
+
+int main() {
+    TtlPriorityQueue<int, int> P;
+
+    P.insert(1, 10, 100);
+    P.insert(2, 20, 50);
+    P.insert(3, 30);  // bez terminu - nie wygasa
+    assert(P.size() == 3);
+    assert(P.pendingDeadlines() == 2);
+
+    // Przed terminem nic nie znika.
+    assert(P.expireUpTo(49) == 0);
+    assert(P.size() == 3);
+
+    // Termin 50 wygasza parę (2, 20).
+    assert(P.expireUpTo(50) == 1);
+    assert(P.size() == 2);
+    assert(!P.contains(2));
+    assert(P.minValue() == 10);
+
+    // Odczyt po przesunięciu zegara wygasza leniwie, bez expireUpTo.
+    P.insert(4, 5, 70);
+    assert(P.minValue() == 5);
+    P.expireUpTo(80);
+    assert(P.minValue() == 10);
+    assert(!P.contains(4));
+
+    // Para zdjęta popem przed terminem: wpis terminowy trafia w próżnię.
+    TtlPriorityQueue<int, int> Q;
+    Q.insert(1, 1, 10);
+    auto mn = Q.popMin();
+    assert(mn.second == 1);
+    assert(Q.expireUpTo(10) == 1);
+    assert(Q.empty());
+
+    // Wygasza się konkretna para (key, value), nie dowolna spod klucza.
+    TtlPriorityQueue<int, int> R;
+    R.insert(7, 1, 5);
+    R.insert(7, 2);
+    R.expireUpTo(5);
+    assert(R.size() == 1);
+    assert(R.anyValueFor(7) == 2);
+
+    // Boksowane typy.
+    TtlPriorityQueue<std::string, std::string> S;
+    S.insert("a", "x", 1);
+    S.insert("b", "y", 2);
+    S.insert("c", "z");
+    S.expireUpTo(2);
+    assert(S.size() == 1 && S.minKey() == "c");
+
+    std::cout << "ALL OK!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+#ifndef _JNP1_TTLPRIORITYQUEUE_HH_
+#define _JNP1_TTLPRIORITYQUEUE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <utility>
+
+#include "priorityqueue.hh"
+
+// Kolejka z terminami ważności elementów: insert(key, value, deadline)
+// dodatkowo zapisuje parę w indeksie uporządkowanym po terminie, a odczyty
+// i popy najpierw leniwie zdejmują przeterminowane czoło tego indeksu.
+// Wygaszanie jest wplecione w operacje, za które i tak płacimy
+// [zamortyzowane O(log n) na wygasły wpis] - bez osobnego wątku skanującego.
+//
+// Zegar podaje wołający przez expireUpTo(now); Deadline to dowolny typ
+// z operator< (milisekundy, time_point, numer slotu). Pary wstawione bez
+// terminu nie wygasają. Terminy są przypięte do wystąpień (key, value):
+// jeśli identyczna para zostanie zdjęta popem i wstawiona ponownie, wpis
+// terminowy pierwszego wystąpienia może wygasić to drugie.
+template <typename K, typename V, typename Deadline = std::uint64_t,
+          typename Allocator = std::allocator<void>,
+          typename Features = DefaultQueueFeatures>
+class TtlPriorityQueue : public PriorityQueue<K, V, Allocator, Features> {
+   public:
+    using base = PriorityQueue<K, V, Allocator, Features>;
+    using size_type = typename base::size_type;
+
+   protected:
+    // Wpis terminowy trzyma kopie K i V: wygaszenie trafia dokładnie tę
+    // parę przez erase_pair(), niezależnie od losów boxów w kolejce.
+    struct entry {
+        Deadline deadline;
+        K key;
+        V value;
+    };
+    struct EntryComparer {
+        bool operator()(const entry& lhs, const entry& rhs) const {
+            return lhs.deadline < rhs.deadline;
+        }
+    };
+    using deadline_set =
+        std::multiset<entry, EntryComparer,
+                      typename base::template rebind_alloc<entry>>;
+
+    deadline_set by_deadline;
+    Deadline now = Deadline();
+
+    // Zdejmuje przeterminowane czoło; para mogła już zejść popem albo
+    // erase(), wtedy erase_pair() nic nie robi.
+    void purge_expired() {
+        while (!by_deadline.empty() &&
+               !(now < by_deadline.begin()->deadline)) {
+            const entry& e = *by_deadline.begin();
+            this->erase_pair(e.key, e.value);
+            by_deadline.erase(by_deadline.begin());
+        }
+    }
+
+   public:
+    TtlPriorityQueue() : TtlPriorityQueue(Allocator()) {}
+    explicit TtlPriorityQueue(const Allocator& alloc)
+        : base(alloc), by_deadline(EntryComparer(), alloc) {}
+
+    using base::insert;
+
+    // Wstawia parę z terminem ważności [O(log size())]
+    void insert(const K& key, const V& value, const Deadline& deadline) {
+        base::insert(key, value);
+        try {
+            by_deadline.insert(entry{deadline, key, value});
+        } catch (...) {
+            this->erase_pair(key, value);
+            throw;
+        }
+    }
+
+    // Przesuwa zegar i od razu wygasza wszystko o terminie <= now;
+    // zwraca liczbę zdjętych wpisów terminowych
+    size_type expireUpTo(const Deadline& now_) {
+        now = now_;
+        size_type before = by_deadline.size();
+        purge_expired();
+        return before - by_deadline.size();
+    }
+
+    // Odczyty i popy najpierw wygaszają przeterminowane czoło (stąd brak
+    // wariantów const - wygaszanie modyfikuje kolejkę).
+    bool empty() {
+        purge_expired();
+        return base::empty();
+    }
+    size_type size() {
+        purge_expired();
+        return base::size();
+    }
+
+    const V& minValue() {
+        purge_expired();
+        return base::minValue();
+    }
+    const V& maxValue() {
+        purge_expired();
+        return base::maxValue();
+    }
+    const K& minKey() {
+        purge_expired();
+        return base::minKey();
+    }
+    const K& maxKey() {
+        purge_expired();
+        return base::maxKey();
+    }
+
+    void deleteMin() {
+        purge_expired();
+        base::deleteMin();
+    }
+    void deleteMax() {
+        purge_expired();
+        base::deleteMax();
+    }
+    std::pair<K, V> popMin() {
+        purge_expired();
+        return base::popMin();
+    }
+    std::pair<K, V> popMax() {
+        purge_expired();
+        return base::popMax();
+    }
+    bool tryPopMin(K& key, V& value) {
+        purge_expired();
+        return base::tryPopMin(key, value);
+    }
+
+    // Liczba wpisów terminowych jeszcze nie wygaszonych (w tym wpisy po
+    // parach zdjętych popem, czekające na swój termin) [O(1)]
+    size_type pendingDeadlines() const noexcept { return by_deadline.size(); }
+};
+
+#endif /* end of include guard: _JNP1_TTLPRIORITYQUEUE_HH_ */